@@ -0,0 +1,200 @@
+// ReSharper disable CppDFAMemoryLeak
+// ReSharper disable CppDFANullDereference
+
+// Throughput benchmark of the atomic map read path against a mads_hash_table_t guarded by a
+// single mutex, the usual way of sharing the hash table between threads. Every thread looks
+// up random keys of a preloaded table; optionally one extra thread keeps replacing values.
+//
+// Usage: mads_atomic_map_benchmark [max_threads] [lookups_per_thread]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <threads.h>
+
+#include <mads/algorithms/random.h>
+#include <mads/data_structures/atomic_map.h>
+#include <mads/data_structures/hash_table.h>
+
+
+#define BENCHMARK_KEYS 100000
+
+
+static int integers_comparator(const void *i, const void *j)
+{
+    const long long int ii = (long long int)i;
+    const long long int jj = (long long int)j;
+    return (ii > jj) - (ii < jj);
+}
+
+static void integers_printer(const void *x)
+{
+    printf("%lld", (long long int)x);
+}
+
+static unsigned long long int hash_integer(const mads_uni_hash_t *uni_hash, const void *data)
+{
+    const unsigned long long int x = (unsigned long long int)data;
+    const unsigned long long int *values = mads_uni_hash_get_values(uni_hash);
+    return ((x * values[0]) ^ ((x >> 32) * values[1])) % mads_uni_hash_get_table_size(uni_hash);
+}
+
+static mads_pair_t *create_integer_pair(const long long int key, const long long int value)
+{
+    mads_cue_t *cue = mads_cue_create((void *)key, integers_comparator, integers_printer, NULL);
+    mads_value_t *v = mads_value_create((void *)value, integers_comparator, integers_printer, NULL);
+    return mads_pair_create(cue, v);
+}
+
+static double benchmark_seconds(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+
+// Shared state of one benchmark run.
+typedef struct
+{
+    mads_atomic_map_t *atomic_map;
+    mads_hash_table_t *hash_table;
+    mtx_t *mutex;
+    long long int lookups;
+    unsigned long long int seed;
+    atomic_int *stop;
+    long long int checksum;
+} benchmark_worker_t;
+
+static int benchmark_reader(void *arg)
+{
+    benchmark_worker_t *worker = arg;
+    unsigned long long int state = worker->seed;
+    long long int checksum = 0;
+
+    for (long long int i = 0; i < worker->lookups; i++)
+    {
+        // A xorshift generator keeps the shared Mersenne Twister out of the measured loop.
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        void *key = (void *)(long long int)(1 + state % BENCHMARK_KEYS);
+
+        if (worker->atomic_map != NULL)
+        {
+            checksum += (long long int)mads_atomic_map_get_value(worker->atomic_map, key);
+        }
+        else
+        {
+            mtx_lock(worker->mutex);
+            checksum += (long long int)mads_hash_table_get_value(worker->hash_table, key);
+            mtx_unlock(worker->mutex);
+        }
+    }
+
+    worker->checksum = checksum;
+    return 0;
+}
+
+static int benchmark_writer(void *arg)
+{
+    benchmark_worker_t *worker = arg;
+    long long int key = 1;
+
+    while (atomic_load(worker->stop) == 0)
+    {
+        if (worker->atomic_map != NULL)
+        {
+            mads_atomic_map_replace(worker->atomic_map, create_integer_pair(key, key));
+        }
+        else
+        {
+            mtx_lock(worker->mutex);
+            mads_hash_table_change_value(worker->hash_table, (void *)key, (void *)key);
+            mtx_unlock(worker->mutex);
+        }
+
+        key = (key % BENCHMARK_KEYS) + 1;
+    }
+
+    return 0;
+}
+
+static double benchmark_run(mads_atomic_map_t *atomic_map,
+    mads_hash_table_t *hash_table,
+    mtx_t *mutex,
+    const int threads,
+    const long long int lookups,
+    const int with_writer)
+{
+    thrd_t readers[64];
+    thrd_t writer;
+    benchmark_worker_t workers[64];
+    benchmark_worker_t writer_worker;
+    atomic_int stop;
+    atomic_init(&stop, 0);
+
+    const double start = benchmark_seconds();
+
+    for (int i = 0; i < threads; i++)
+    {
+        workers[i].atomic_map = atomic_map;
+        workers[i].hash_table = hash_table;
+        workers[i].mutex = mutex;
+        workers[i].lookups = lookups;
+        workers[i].seed = mads_genrand64_int64() | 1ULL;
+        workers[i].stop = &stop;
+        thrd_create(&readers[i], benchmark_reader, &workers[i]);
+    }
+
+    if (with_writer == 1)
+    {
+        writer_worker = workers[0];
+        thrd_create(&writer, benchmark_writer, &writer_worker);
+    }
+
+    for (int i = 0; i < threads; i++)
+    {
+        thrd_join(readers[i], NULL);
+    }
+
+    const double elapsed = benchmark_seconds() - start;
+    atomic_store(&stop, 1);
+    if (with_writer == 1) { thrd_join(writer, NULL); }
+    return (double)threads * (double)lookups / elapsed;
+}
+
+
+int main(const int argc, char **argv)
+{
+    mtx_t mutex;
+    const int max_threads = (argc > 1 ? atoi(argv[1]) : 8);
+    const long long int lookups = (argc > 2 ? atoll(argv[2]) : 2000000);
+    mads_atomic_map_t *atomic_map = mads_atomic_map_create(hash_integer, 2 * BENCHMARK_KEYS);
+    mads_hash_table_t *hash_table = mads_hash_table_create_with_capacity(hash_integer, MADS_HASH_TABLE_CHAIN_LIST, BENCHMARK_KEYS, NULL);
+    mtx_init(&mutex, mtx_plain);
+
+    for (long long int key = 1; key <= BENCHMARK_KEYS; key++)
+    {
+        mads_atomic_map_insert(atomic_map, create_integer_pair(key, key));
+        mads_hash_table_insert(hash_table, create_integer_pair(key, key));
+    }
+
+    printf("%-8s %-8s %20s %20s\n", "threads", "writer", "atomic_map ops/s", "mutex+table ops/s");
+
+    for (int with_writer = 0; with_writer <= 1; with_writer++)
+    {
+        for (int threads = 1; threads <= max_threads && threads <= 64; threads *= 2)
+        {
+            const double atomic_rate = benchmark_run(atomic_map, NULL, NULL, threads, lookups, with_writer);
+            const double mutex_rate = benchmark_run(NULL, hash_table, &mutex, threads, lookups, with_writer);
+            printf("%-8d %-8s %20.0f %20.0f\n", threads, (with_writer == 1 ? "yes" : "no"), atomic_rate, mutex_rate);
+        }
+    }
+
+    mtx_destroy(&mutex);
+    mads_atomic_map_free(&atomic_map);
+    mads_hash_table_free(&hash_table);
+    return 0;
+}
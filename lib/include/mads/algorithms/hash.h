@@ -0,0 +1,70 @@
+// ReSharper disable CppDoxygenUnresolvedReference
+
+/**
+ * @file hash.h
+ * @brief Contains prototypes for general purpose key hashing functions.
+ * The functions follow the design of wyhash: the input is read eight bytes at a time and mixed
+ * with full 64x64 to 128-bit multiplications, using three independent lanes over 48-byte blocks
+ * so the multiplications of a block overlap in the pipeline.
+ *
+ * Every function is seeded from the random seeds of a mads_uni_hash_t, so every universal hash
+ * selects a different hash function; the hash table draws its own once, when it is created. The result is
+ * reduced to the table size of the universal hash, with a mask when it is a power of two. The
+ * string, integer and pointer functions match mads_hash_table_hash_fn and can be passed straight
+ * to mads_hash_table_create.
+ */
+
+
+#ifndef MADS_ALGORITHMS_HASH_H
+#define MADS_ALGORITHMS_HASH_H
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#include <mads_export.h>
+#include <mads/data_structures/uni_hash.h>
+
+
+/**
+ * @brief Function to hash a byte string.
+ * @param[in] h The universal hash providing the seeds and the table size.
+ * @param[in] data Pointer to the bytes to hash.
+ * @param[in] length The number of bytes to hash.
+ * @return The hash of the bytes, reduced to the table size.
+ */
+MADS_EXPORT unsigned long long int mads_hash_bytes(const mads_uni_hash_t *h, const void *data, unsigned long long int length);
+
+/**
+ * @brief Function to hash a NUL-terminated string. It equals mads_hash_bytes over the characters of the string.
+ * @param[in] h The universal hash providing the seeds and the table size.
+ * @param[in] data Pointer to the string to hash.
+ * @return The hash of the string, reduced to the table size.
+ */
+MADS_EXPORT unsigned long long int mads_hash_string(const mads_uni_hash_t *h, const void *data);
+
+/**
+ * @brief Function to hash a 64-bit integer stored in place of the key pointer, i.e. a key inserted as (void *)number.
+ * @param[in] h The universal hash providing the seeds and the table size.
+ * @param[in] data The integer key, stored in the pointer itself.
+ * @return The hash of the integer, reduced to the table size.
+ */
+MADS_EXPORT unsigned long long int mads_hash_integer(const mads_uni_hash_t *h, const void *data);
+
+/**
+ * @brief Function to hash a pointer by its address, for keys compared by identity.
+ * @param[in] h The universal hash providing the seeds and the table size.
+ * @param[in] data The pointer to hash.
+ * @return The hash of the address, reduced to the table size.
+ */
+MADS_EXPORT unsigned long long int mads_hash_pointer(const mads_uni_hash_t *h, const void *data);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif //MADS_ALGORITHMS_HASH_H
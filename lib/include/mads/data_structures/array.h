@@ -9,6 +9,11 @@
  * to your stored elements. It supports adding elements in different ways: appending, prepending,
  * and inserting at a specific index. Removing an element at a specific index is also supported.
  *
+ * The blocks are used as a circular buffer: the first element sits at a head offset that moves
+ * backwards on prepends and forwards on removals at the front, so both run in constant time and the
+ * array can serve as a FIFO queue. Insertions and removals elsewhere shift whichever side of the
+ * index is shorter, with memmove.
+ *
  * Each array must contain three important function pointers: a comparator for comparing elements,
  * a printer for displaying elements, and a destructor for deleting the elements.
  */
@@ -50,6 +55,7 @@ typedef void (*mads_array_destructor_fn)(void *);
 typedef struct
 {
     void **mblocks; ///< @brief Pointers to blocks holding array elements
+    size_t head; ///< @brief Position in the blocks of the first element, the blocks wrapping around after the last one
     size_t size; ///< @brief Current number of elements.
     size_t memsize; ///< @brief Maximum memory size of the array
     mads_array_comparator_fn comparator; ///< @brief Comparator function for array elements
@@ -69,10 +75,25 @@ MADS_EXPORT mads_array_t *mads_array_create(mads_array_comparator_fn comparator,
 
 /**
  * @brief Function that returns the raw memory blocks of the array.
- * @param[in] array The array data structure
- * @return The memory blocks of the array.
+ * If the elements wrap around the end of the blocks, they are first moved to a contiguous layout.
+ * @param[in,out] array The array data structure
+ * @return The memory blocks of the array, starting with the first element.
+ */
+MADS_EXPORT void **mads_array_data(mads_array_t *array);
+
+/**
+ * @brief Function to make room for at least the given number of elements in the array.
+ * Reserving ahead of a bulk load replaces the repeated doublings with a single reallocation.
+ * @param[in,out] array The array to reserve memory in
+ * @param[in] capacity The number of elements the array must hold without growing
+ */
+MADS_EXPORT void mads_array_reserve(mads_array_t *array, size_t capacity);
+
+/**
+ * @brief Function to release the memory the array holds beyond its current elements
+ * @param[in,out] array The array to shrink
  */
-MADS_EXPORT void **mads_array_data(const mads_array_t *array);
+MADS_EXPORT void mads_array_shrink_to_fit(mads_array_t *array);
 
 /**
  * @brief Function to append data to an array
@@ -96,6 +117,23 @@ MADS_EXPORT void mads_array_prepend(mads_array_t *array, void *data);
  */
 MADS_EXPORT void mads_array_insert_at(mads_array_t *array, size_t index, void *data);
 
+/**
+ * @brief Function to insert several data at a specific index in the array, growing it at most once
+ * @param[in,out] array The array to insert into
+ * @param[in] index The position index where the first new data is to be inserted
+ * @param[in] data The buffer holding the new data to insert, in order
+ * @param[in] count The number of data in the buffer
+ */
+MADS_EXPORT void mads_array_insert_range(mads_array_t *array, size_t index, void *const *data, size_t count);
+
+/**
+ * @brief Function to append several data to an array, growing it at most once
+ * @param[in,out] array The array to append to
+ * @param[in] data The buffer holding the data to append, in order
+ * @param[in] count The number of data in the buffer
+ */
+MADS_EXPORT void mads_array_append_n(mads_array_t *array, void *const *data, size_t count);
+
 /**
  * @brief Function to remove data at a specific index in the array
  * @param[in,out] array The array to remove data from
@@ -103,6 +141,15 @@ MADS_EXPORT void mads_array_insert_at(mads_array_t *array, size_t index, void *d
  */
 MADS_EXPORT void mads_array_remove_at(mads_array_t *array, size_t index);
 
+/**
+ * @brief Function to remove several consecutive data from the array, shifting the rest once.
+ * The destructor, if any, is still called on every removed element.
+ * @param[in,out] array The array to remove data from
+ * @param[in] index The position index of the first data to be removed
+ * @param[in] count The number of data to be removed
+ */
+MADS_EXPORT void mads_array_remove_range(mads_array_t *array, size_t index, size_t count);
+
 /**
  * @brief Function to set data at a specific index in the array
  * @param[in,out] array The array to set data in
@@ -0,0 +1,155 @@
+// ReSharper disable CppDoxygenUnresolvedReference
+
+/**
+ * @file atomic_map.h
+ * @brief This header file provides an API for managing a read-mostly concurrent hash map.
+ * In this file a hash map with a lock-free read path is implemented. Pairs are stored in nodes
+ * chained from a fixed array of buckets, and every link is a C11 atomic pointer. Readers never
+ * take a lock: they announce themselves in the current epoch and walk the chain. Writers are
+ * serialized per bucket by a striped set of mutexes and publish every change with a single
+ * atomic store, so a reader always sees either the old or the new chain.
+ *
+ * Removed nodes are not freed right away. They are retired with the current epoch and freed by
+ * epoch-based reclamation, once every reader that could still be looking at them has left. The
+ * number of buckets is fixed at creation, so the map should be sized for its expected contents.
+ */
+
+#ifndef MADS_DATA_STRUCTURES_ATOMIC_MAP_H
+#define MADS_DATA_STRUCTURES_ATOMIC_MAP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def MADS_ATOMIC_MAP_LOCK_STRIPES
+ * @brief A macro constant to specify the maximum number of mutexes serializing the writers.
+ */
+#define MADS_ATOMIC_MAP_LOCK_STRIPES 64
+
+/**
+ * @def MADS_ATOMIC_MAP_READER_STRIPES
+ * @brief A macro constant to specify the number of cache line sized reader counters the threads are spread over.
+ */
+#define MADS_ATOMIC_MAP_READER_STRIPES 16
+
+#include <threads.h>
+#include <stdatomic.h>
+#include <mads_export.h>
+#include <mads/data_structures/uni_hash.h>
+#include <mads/data_structures/pair.h>
+#include <mads/data_structures/hash_table.h>
+
+
+/**
+ * @brief Data structure representing a node of the atomic map.
+ */
+typedef struct mads_atomic_map_node_t
+{
+    mads_pair_t *pair; ///< @brief The pair stored in the node, never changed once the node is published.
+    _Atomic(struct mads_atomic_map_node_t *) next; ///< @brief The next node of the bucket chain.
+    struct mads_atomic_map_node_t *retired_next; ///< @brief The next node of the retired list.
+    unsigned long long int retire_epoch; ///< @brief The epoch in which the node was removed from its chain.
+} mads_atomic_map_node_t;
+
+
+/**
+ * @brief Data structure representing the reader counters of a stripe of threads.
+ * Each stripe fills a cache line of its own, so readers of different stripes never contend.
+ */
+typedef struct
+{
+    atomic_ullong count[3]; ///< @brief The number of active readers per epoch, indexed by epoch modulo three.
+    char padding[64 - 3 * sizeof(atomic_ullong)]; ///< @brief Padding up to a cache line.
+} mads_atomic_map_readers_t;
+
+
+/**
+ * @brief Data structure representing an atomic map.
+ */
+typedef struct
+{
+    _Atomic(mads_atomic_map_node_t *) *buckets; ///< @brief The heads of the bucket chains.
+    unsigned long long int size; ///< @brief The fixed number of buckets.
+    mtx_t *locks; ///< @brief The mutexes serializing the writers, bucket i uses lock i modulo lock_count.
+    unsigned long long int lock_count; ///< @brief The number of writer mutexes.
+    atomic_ullong n; ///< @brief The number of elements in the atomic map.
+    atomic_ullong epoch; ///< @brief The global epoch.
+    mads_atomic_map_readers_t readers[MADS_ATOMIC_MAP_READER_STRIPES]; ///< @brief The striped reader counters.
+    mtx_t retire_mutex; ///< @brief The mutex guarding the retired list and the epoch advance.
+    mads_atomic_map_node_t *retired; ///< @brief The nodes removed from their chain and waiting to be freed.
+    mads_uni_hash_t *hfunc; ///< @brief A universal hashing function data structure.
+    mads_hash_table_hash_fn hash; ///< @brief The user-defined hashing function for the key element.
+} mads_atomic_map_t;
+
+
+/**
+ * @brief Function to create a new atomic map.
+ * @param[in] hash The hashing function for the key element.
+ * @param[in] size The number of buckets, which never changes.
+ * @return Pointer to created atomic map.
+ */
+MADS_EXPORT mads_atomic_map_t *mads_atomic_map_create(mads_hash_table_hash_fn hash, unsigned long long int size);
+
+/**
+ * @brief Function to insert a (key, value) pair into the atomic map.
+ * @param[in,out] m The atomic map to insert into.
+ * @param[in] p The key value pair to add. If its key already exists the pair is not inserted and remains owned by the caller.
+ * @return One if the pair was inserted, zero otherwise.
+ */
+MADS_EXPORT int mads_atomic_map_insert(mads_atomic_map_t *m, mads_pair_t *p);
+
+/**
+ * @brief Function to insert a (key, value) pair into the atomic map, replacing the pair holding the same key.
+ * Pairs are never modified in place: the replaced pair is retired and freed once no reader can see it.
+ * @param[in,out] m The atomic map to insert into.
+ * @param[in] p The key value pair to add.
+ */
+MADS_EXPORT void mads_atomic_map_replace(mads_atomic_map_t *m, mads_pair_t *p);
+
+/**
+ * @brief Function to look up the atomic map for the given key. It never takes a lock.
+ * @param[in] m The atomic map to perform the lookup.
+ * @param[in] key The key element to search for.
+ * @return One if the key already exists, zero otherwise.
+ */
+MADS_EXPORT int mads_atomic_map_lookup(mads_atomic_map_t *m, const void *key);
+
+/**
+ * @brief Function to retrieve the value associated with the given key element from the atomic map. It never takes a lock.
+ * The value is returned as is: a value owned by the map may be freed once another thread removes or replaces its key.
+ * @param[in] m The atomic map from which to retrieve the value element of the given key.
+ * @param[in] key The key element whose value we must retrieve.
+ * @return The value associated with the given key, or NULL if the key does not exist.
+ */
+MADS_EXPORT void *mads_atomic_map_get_value(mads_atomic_map_t *m, const void *key);
+
+/**
+ * @brief Function to remove a (key, value) pair from the atomic map.
+ * The pair is retired and freed once no reader can see it.
+ * @param[in,out] m The atomic map from which to remove.
+ * @param[in] key The key element to be removed.
+ */
+MADS_EXPORT void mads_atomic_map_remove(mads_atomic_map_t *m, const void *key);
+
+/**
+ * @brief Function to print the contents of the atomic map.
+ * No other thread may update the map while it is printed.
+ * @param[in] m The atomic map whose contents will be printed.
+ */
+MADS_EXPORT void mads_atomic_map_print(const mads_atomic_map_t *m);
+
+/**
+ * @brief Function to free atomic map and release all allocated memory, including the retired pairs.
+ * No other thread may use the map while it is freed.
+ * @param[in,out] m The atomic map to be freed.
+ */
+MADS_EXPORT void mads_atomic_map_free(mads_atomic_map_t **m);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif //MADS_DATA_STRUCTURES_ATOMIC_MAP_H
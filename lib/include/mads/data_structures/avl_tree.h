@@ -37,10 +37,11 @@ typedef struct
 
 MADS_EXPORT mads_avl_tree_t *mads_avl_tree_create(mads_avl_tree_comparator_fn comparator, mads_avl_tree_printer_fn printer, mads_avl_tree_destructor_fn destructor);
 MADS_EXPORT void mads_avl_tree_insert(mads_avl_tree_t *t, void *data);
+MADS_EXPORT void *mads_avl_tree_find_or_insert(mads_avl_tree_t *t, void *data);
 MADS_EXPORT int mads_avl_tree_search(const mads_avl_tree_t *t, void *item);
 MADS_EXPORT void *mads_avl_tree_get_elem(const mads_avl_tree_t *t, void *item);
 MADS_EXPORT void *mads_avl_tree_get_root(const mads_avl_tree_t *t);
-MADS_EXPORT void mads_avl_tree_remove(mads_avl_tree_t *t, void *item);
+MADS_EXPORT int mads_avl_tree_remove(mads_avl_tree_t *t, void *item);
 MADS_EXPORT void mads_avl_tree_remove_root(mads_avl_tree_t *t);
 MADS_EXPORT int mads_avl_tree_is_empty(const mads_avl_tree_t *t);
 MADS_EXPORT int mads_avl_tree_get_height(const mads_avl_tree_t *t);
@@ -0,0 +1,150 @@
+// ReSharper disable CppDoxygenUnresolvedReference
+
+/**
+ * @file concurrent_hash_table.h
+ * @brief This header file provides an API for managing a concurrent hash table.
+ * In this file a thread safe hash table is implemented on top of mads_hash_table_t. The key space
+ * is striped over a fixed number of shards, each one an independent hash table guarded by its own
+ * reader-writer lock. Lookups on a shard run in parallel, updates lock only the shard they touch,
+ * and every shard resizes on its own, so one shard growing never blocks the others.
+ *
+ * Shards are selected with a universal hashing function of their own, independent of the one each
+ * shard uses to index its buckets. The locks are built from the C11 threads library.
+ */
+
+#ifndef MADS_DATA_STRUCTURES_CONCURRENT_HASH_TABLE_H
+#define MADS_DATA_STRUCTURES_CONCURRENT_HASH_TABLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <threads.h>
+#include <mads_export.h>
+#include <mads/data_structures/uni_hash.h>
+#include <mads/data_structures/pair.h>
+#include <mads/data_structures/hash_table.h>
+
+
+/**
+ * @brief Data structure representing a shard of a concurrent hash table.
+ * The mutex and condition variable implement a writer preferring reader-writer lock.
+ */
+typedef struct
+{
+    mtx_t mutex; ///< @brief The mutex guarding the lock state of the shard.
+    cnd_t condition; ///< @brief The condition variable signalled whenever the lock is released.
+    unsigned long long int readers; ///< @brief The number of threads holding the shard for reading.
+    unsigned long long int waiting_writers; ///< @brief The number of threads waiting to hold the shard for writing.
+    int writing; ///< @brief One if a thread holds the shard for writing, zero otherwise.
+    mads_hash_table_t *table; ///< @brief The hash table holding the elements of the shard.
+} mads_concurrent_hash_table_shard_t;
+
+
+/**
+ * @brief Data structure representing a concurrent hash table.
+ */
+typedef struct
+{
+    mads_concurrent_hash_table_shard_t *shards; ///< @brief The shards of the concurrent hash table.
+    unsigned long long int shard_count; ///< @brief The number of shards.
+    mads_uni_hash_t *shard_hfunc; ///< @brief A universal hashing function data structure selecting the shard of a key.
+    mads_hash_table_hash_fn hash; ///< @brief The user-defined hashing function for the key element.
+} mads_concurrent_hash_table_t;
+
+
+/**
+ * @brief Function to create a new concurrent hash table.
+ * @param[in] hash The hashing function for the key element.
+ * @param[in] chain_type The type of the collision resolution method of the shards. One of MADS_HASH_TABLE_CHAIN_LIST,
+ * MADS_HASH_TABLE_CHAIN_TREE, MADS_HASH_TABLE_CHAIN_HYBRID or MADS_HASH_TABLE_OPEN_ROBIN_HOOD.
+ * @param[in] shard_count The number of shards, usually a small multiple of the number of threads.
+ * @return Pointer to created concurrent hash table.
+ */
+MADS_EXPORT mads_concurrent_hash_table_t *mads_concurrent_hash_table_create(mads_hash_table_hash_fn hash,
+    int chain_type,
+    unsigned long long int shard_count);
+
+/**
+ * @brief Function to create a new concurrent hash table whose shards use the given options.
+ * A positive rehash step bounds the time a shard is held for writing while it resizes.
+ * @param[in] hash The hashing function for the key element.
+ * @param[in] chain_type The type of the collision resolution method of the shards.
+ * @param[in] shard_count The number of shards.
+ * @param[in] options The options of every shard. If NULL the default options are used.
+ * @return Pointer to created concurrent hash table.
+ */
+MADS_EXPORT mads_concurrent_hash_table_t *mads_concurrent_hash_table_create_with_options(mads_hash_table_hash_fn hash,
+    int chain_type,
+    unsigned long long int shard_count,
+    const mads_hash_table_options_t *options);
+
+/**
+ * @brief Function to insert a (key, value) pair into the concurrent hash table.
+ * @param[in,out] t The concurrent hash table to insert into.
+ * @param[in] p The key value pair to add. If its key already exists the pair is not inserted and remains owned by the caller.
+ * @return One if the pair was inserted, zero otherwise.
+ */
+MADS_EXPORT int mads_concurrent_hash_table_insert(mads_concurrent_hash_table_t *t, mads_pair_t *p);
+
+/**
+ * @brief Function to look up the concurrent hash table for the given key.
+ * @param[in] t The concurrent hash table to perform the lookup.
+ * @param[in] key The key element to search for.
+ * @return One if the key already exists, zero otherwise.
+ */
+MADS_EXPORT int mads_concurrent_hash_table_lookup(const mads_concurrent_hash_table_t *t, void *key);
+
+/**
+ * @brief Function to remove a (key, value) pair from the concurrent hash table.
+ * @param[in,out] t The concurrent hash table from which to remove.
+ * @param[in] key The key element to be removed.
+ */
+MADS_EXPORT void mads_concurrent_hash_table_remove(mads_concurrent_hash_table_t *t, void *key);
+
+/**
+ * @brief Function to retrieve the value associated with the given key element from the concurrent hash table.
+ * The value is read under the lock of its shard, but it is returned as is: values owned by the table
+ * must not be removed or replaced by another thread while the caller still uses them.
+ * @param[in] t The concurrent hash table from which to retrieve the value element of the given key.
+ * @param[in] key The key element whose value we must retrieve.
+ * @return The value associated with the given key, or NULL if the key does not exist.
+ */
+MADS_EXPORT void *mads_concurrent_hash_table_get_value(const mads_concurrent_hash_table_t *t, void *key);
+
+/**
+ * @brief Function to change the value associated with the given key element in the concurrent hash table.
+ * @param[in,out] t The concurrent hash table in which to change the value element of the given key.
+ * @param[in] key The key element whose value must be changed.
+ * @param[in] value The new value to replace the old one.
+ */
+MADS_EXPORT void mads_concurrent_hash_table_change_value(mads_concurrent_hash_table_t *t, void *key, void *value);
+
+/**
+ * @brief Function to get the number of elements in the concurrent hash table.
+ * Each shard is counted under its own lock, so the result is exact only while no thread updates the table.
+ * @param[in] t The concurrent hash table.
+ * @return The number of elements in the concurrent hash table.
+ */
+MADS_EXPORT unsigned long long int mads_concurrent_hash_table_size(const mads_concurrent_hash_table_t *t);
+
+/**
+ * @brief Function to print the contents of the concurrent hash table.
+ * @param[in] t The concurrent hash table whose contents will be printed.
+ */
+MADS_EXPORT void mads_concurrent_hash_table_print(const mads_concurrent_hash_table_t *t);
+
+/**
+ * @brief Function to free concurrent hash table and release all allocated memory.
+ * No other thread may use the table while it is freed.
+ * @param[in,out] t The concurrent hash table to be freed.
+ */
+MADS_EXPORT void mads_concurrent_hash_table_free(mads_concurrent_hash_table_t **t);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif //MADS_DATA_STRUCTURES_CONCURRENT_HASH_TABLE_H
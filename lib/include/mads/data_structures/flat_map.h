@@ -0,0 +1,136 @@
+// ReSharper disable CppDoxygenUnresolvedReference
+
+/**
+ * @file flat_map.h
+ * @brief This header file provides an API for managing a flat hash map.
+ * In this file a generic open addressing hash map is implemented in the style of a Swiss table.
+ * Pairs are stored in a flat array of slots and every slot has a companion control byte which
+ * holds a 7-bit fingerprint of the key's hash, or marks the slot as empty or deleted. A probe
+ * scans the control bytes of a whole group of slots at once (with SSE2 when available and a
+ * scalar loop otherwise) and only calls the key comparator on fingerprint hits.
+ *
+ * The flat map accepts the same hashing function as the hash table, so existing users of
+ * mads_hash_table_t can migrate table by table.
+ */
+
+#ifndef MADS_DATA_STRUCTURES_FLAT_MAP_H
+#define MADS_DATA_STRUCTURES_FLAT_MAP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def MADS_FLAT_MAP_GROUP_WIDTH
+ * @brief A macro constant to specify the number of slots whose control bytes are scanned together.
+ */
+#define MADS_FLAT_MAP_GROUP_WIDTH 16
+
+/**
+ * @def MADS_FLAT_MAP_INITIAL_SIZE
+ * @brief A macro constant to specify the initial number of slots of the flat map.
+ */
+#define MADS_FLAT_MAP_INITIAL_SIZE 16
+
+/**
+ * @def MADS_FLAT_MAP_FINGERPRINT_BITS
+ * @brief A macro constant to specify the number of hash bits kept in a control byte.
+ */
+#define MADS_FLAT_MAP_FINGERPRINT_BITS 7
+
+#include <mads_export.h>
+#include <mads/data_structures/uni_hash.h>
+#include <mads/data_structures/pair.h>
+#include <mads/data_structures/hash_table.h>
+
+
+/**
+ * @brief Data structure representing a flat hash map.
+ * The universal hashing function of the map is created with a table size of
+ * capacity * 2^MADS_FLAT_MAP_FINGERPRINT_BITS, so the hashed index of a key
+ * carries both its home slot and its fingerprint. The capacity is a power of two,
+ * so the hash is drawn with mads_uni_hash_create_pow2 and growing needs no primality search.
+ */
+typedef struct
+{
+    signed char *ctrl; ///< @brief Control bytes, one per slot: a fingerprint, or an empty or deleted marker.
+    mads_pair_t **slots; ///< @brief Pointers to the pairs stored in the map.
+    unsigned long long int n; ///< @brief The number of elements in the flat map.
+    unsigned long long int deleted; ///< @brief The number of deleted slots that are still marked as such.
+    unsigned long long int capacity; ///< @brief The number of slots, a power of two multiple of the group width.
+    mads_uni_hash_t *hfunc; ///< @brief A universal hashing function data structure.
+    mads_hash_table_hash_fn hash; ///< @brief The user-defined hashing function for the key element.
+} mads_flat_map_t;
+
+
+/**
+ * @brief Function to create a new flat map.
+ * @param[in] hash The hashing function for the key element.
+ * @return Pointer to created flat map.
+ */
+MADS_EXPORT mads_flat_map_t *mads_flat_map_create(mads_hash_table_hash_fn hash);
+
+/**
+ * @brief Function to insert a (key, value) pair into the flat map.
+ * If the key already exists the pair is not inserted.
+ * @param[in,out] m The flat map to insert into.
+ * @param[in] p The key value pair to add.
+ */
+MADS_EXPORT void mads_flat_map_insert(mads_flat_map_t *m, mads_pair_t *p);
+
+/**
+ * @brief Function to look up the flat map for the given key.
+ * @param[in] m The flat map to perform the lookup.
+ * @param[in] key The key element to search for.
+ * @return One if the key already exists, zero otherwise.
+ */
+MADS_EXPORT int mads_flat_map_lookup(const mads_flat_map_t *m, const void *key);
+
+/**
+ * @brief Function to remove a (key, value) pair from the flat map.
+ * @param[in,out] m The flat map from which to remove.
+ * @param[in] key The key element to be removed.
+ */
+MADS_EXPORT void mads_flat_map_remove(mads_flat_map_t *m, const void *key);
+
+/**
+ * @brief Function to retrieve the value associated with the given key element from the flat map.
+ * @param[in] m The flat map from which to retrieve the value element of the given key.
+ * @param[in] key The key element whose value we must retrieve.
+ * @return The value associated with the given key, or NULL if the key does not exist.
+ */
+MADS_EXPORT void *mads_flat_map_get_value(const mads_flat_map_t *m, const void *key);
+
+/**
+ * @brief Function to change the value associated with the given key element in the flat map.
+ * @param[in,out] m The flat map in which to change the value element of the given key.
+ * @param[in] key The key element whose value must be changed.
+ * @param[in] value The new value to replace the old one.
+ */
+MADS_EXPORT void mads_flat_map_change_value(const mads_flat_map_t *m, const void *key, void *value);
+
+/**
+ * @brief Function to clear the flat map, keeping its slots allocated.
+ * @param[in,out] m Flat map data structure to be cleared.
+ */
+MADS_EXPORT void mads_flat_map_clear(mads_flat_map_t *m);
+
+/**
+ * @brief Function to print the contents of the flat map.
+ * @param[in] m The flat map whose contents will be printed.
+ */
+MADS_EXPORT void mads_flat_map_print(const mads_flat_map_t *m);
+
+/**
+ * @brief Function to free flat map and release all allocated memory.
+ * @param[in,out] m The flat map to be freed.
+ */
+MADS_EXPORT void mads_flat_map_free(mads_flat_map_t **m);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif //MADS_DATA_STRUCTURES_FLAT_MAP_H
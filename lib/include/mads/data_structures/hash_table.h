@@ -5,7 +5,9 @@
  * @brief This header file provides an API for managing a hash table.
  * In this file a generic hash table is implemented. It includes methods for create,
  * manipulate and destroy hash tables. It supports insertion, lookup, removal and
- * changing the value of a hash table key.
+ * changing the value of a hash table key. Collisions are resolved either by separate chaining,
+ * with linked lists, balanced trees or lists that turn into trees once they grow long as buckets,
+ * or by open addressing with Robin Hood linear probing over a flat array of slots.
  *
  * Each hash table must contain an important function pointer: a universal hashing function
  * which tells it how to hash the key values for insertion and queries into the hash table.
@@ -24,6 +26,37 @@ extern "C" {
  */
 #define MADS_HASH_TABLE_INITIAL_SIZE 107
 
+/**
+ * @def MADS_HASH_TABLE_MAX_LOAD_FACTOR
+ * @brief A macro constant to specify the default load factor above which the hash table grows.
+ */
+#define MADS_HASH_TABLE_MAX_LOAD_FACTOR 0.85
+
+/**
+ * @def MADS_HASH_TABLE_GROWTH_FACTOR
+ * @brief A macro constant to specify the default factor by which the hash table multiplies its size when it grows.
+ */
+#define MADS_HASH_TABLE_GROWTH_FACTOR 2.0
+
+/**
+ * @def MADS_HASH_TABLE_STATS_HISTOGRAM
+ * @brief A macro constant to specify the number of bins of the chain length histogram, the last bin counting every longer chain.
+ */
+#define MADS_HASH_TABLE_STATS_HISTOGRAM 16
+
+/**
+ * @def MADS_HASH_TABLE_BATCH_GROUP
+ * @brief A macro constant to specify the number of keys whose buckets are prefetched together by the batch operations.
+ */
+#define MADS_HASH_TABLE_BATCH_GROUP 16
+
+/**
+ * @def MADS_HASH_TABLE_ITER_STACK
+ * @brief A macro constant to specify the depth of the node stack of an iterator.
+ * It bounds the height of a tree bucket, which for a balanced tree is about 1.44 log2 of its size.
+ */
+#define MADS_HASH_TABLE_ITER_STACK 96
+
 /**
  * @def MADS_HASH_TABLE_CHAIN_LIST
  * @brief A macro constant to represent separate chaining via linked lists.
@@ -36,6 +69,60 @@ extern "C" {
  */
 #define MADS_HASH_TABLE_CHAIN_TREE 84
 
+/**
+ * @def MADS_HASH_TABLE_CHAIN_HYBRID
+ * @brief A macro constant to represent separate chaining via linked lists that are converted to balanced trees when they grow long.
+ * A bucket starts as a list and becomes a tree once it holds more than MADS_HASH_TABLE_TREEIFY_THRESHOLD
+ * pairs, so the common short chains are walked as lists while a flood of colliding keys costs logarithmic
+ * time. A tree bucket turns back into a list once its height falls to MADS_HASH_TABLE_UNTREEIFY_HEIGHT.
+ */
+#define MADS_HASH_TABLE_CHAIN_HYBRID 72
+
+/**
+ * @def MADS_HASH_TABLE_TREEIFY_THRESHOLD
+ * @brief A macro constant to specify the number of pairs above which a list bucket of a hybrid table becomes a tree.
+ */
+#define MADS_HASH_TABLE_TREEIFY_THRESHOLD 8
+
+/**
+ * @def MADS_HASH_TABLE_UNTREEIFY_HEIGHT
+ * @brief A macro constant to specify the height at which a tree bucket of a hybrid table becomes a list again.
+ * A tree of height two holds at most seven pairs, below the treeify threshold, so a bucket does not flip back and forth.
+ */
+#define MADS_HASH_TABLE_UNTREEIFY_HEIGHT 2
+
+/**
+ * @def MADS_HASH_TABLE_OPEN_ROBIN_HOOD
+ * @brief A macro constant to represent open addressing via Robin Hood linear probing.
+ */
+#define MADS_HASH_TABLE_OPEN_ROBIN_HOOD 82
+
+/**
+ * @def MADS_HASH_TABLE_SIZING_PRIME
+ * @brief A macro constant to represent bucket arrays sized with prime numbers.
+ * The cached hash code is reduced modulo the prime size, so every bit of the code takes part in the
+ * index and codes whose low bits are poor, such as multiples of a power of two, still spread over
+ * all buckets. The universal hash given to the hashing function is the same as under
+ * MADS_HASH_TABLE_SIZING_POW2, with random odd coefficients rather than primes: a prime table no
+ * longer hands out prime multipliers, only the prime reduction of the result.
+ */
+#define MADS_HASH_TABLE_SIZING_PRIME 80
+
+/**
+ * @def MADS_HASH_TABLE_SIZING_POW2
+ * @brief A macro constant to represent bucket arrays sized with powers of two.
+ * Resizing needs no primality search and the index is computed with a mixing step and a mask.
+ */
+#define MADS_HASH_TABLE_SIZING_POW2 50
+
+/**
+ * @def MADS_HASH_TABLE_HASH_RANGE
+ * @brief A macro constant to specify the table size of the universal hashing function of the hash table.
+ * The hashing function is not recreated on resize, so it hashes into this fixed wide range. The
+ * resulting hash code is cached in the pair and reduced to the size of the bucket array.
+ */
+#define MADS_HASH_TABLE_HASH_RANGE (1ULL << 63)
+
 #include <mads_export.h>
 #include <mads/data_structures/uni_hash.h>
 #include <mads/data_structures/pair.h>
@@ -48,37 +135,328 @@ extern "C" {
  */
 typedef unsigned long long int (*mads_hash_table_hash_fn)(const mads_uni_hash_t *, const void *);
 
+/**
+ * @brief A hashing function for a byte slice key, used by the borrowed key lookups.
+ * @param[in] Pointer to a mads_uni_hash_t data structure.
+ * @param[in] GenericPointer to the first byte of the slice.
+ * @param[in] The number of bytes in the slice.
+ * @return An unsigned integer that represents the computed index.
+ */
+typedef unsigned long long int (*mads_hash_table_hash_by_fn)(const mads_uni_hash_t *, const void *, unsigned long long int);
+
+/**
+ * @brief A comparator between a stored key and a byte slice key, used by the borrowed key lookups.
+ * @param[in] GenericPointer to the key stored in the cue of a pair.
+ * @param[in] GenericPointer to the first byte of the slice.
+ * @param[in] The number of bytes in the slice.
+ * @return Zero if the keys are equal, a negative or positive integer if the stored key orders before or after the slice.
+ */
+typedef int (*mads_hash_table_compare_by_fn)(const void *, const void *, unsigned long long int);
+
+
+/**
+ * @brief Data structure representing a slot of an open addressing hash table.
+ * Pairs are stored inline in a flat array of slots, so no bucket container is
+ * allocated and a probe touches consecutive memory.
+ */
+typedef struct
+{
+    mads_pair_t *pair; ///< @brief The pair stored in the slot, NULL if the slot is empty.
+    unsigned long long int hash; ///< @brief The hashed index of the pair's key, i.e. its home slot.
+} mads_hash_table_slot_t;
+
+
+/**
+ * @brief Data structure holding the tunable options of a hash table.
+ * Obtain the defaults with mads_hash_table_default_options and override the fields of interest.
+ */
+typedef struct
+{
+    /**
+     * @brief The number of buckets migrated by each insertion or removal while the table is resizing.
+     * Zero (the default) moves every pair at once when the table grows. A positive value
+     * spreads the resize over the following updates, bounding the latency of any single one.
+     * A step too small to finish before the table resizes again is raised as needed, to the
+     * old buckets left divided by the updates left before that resize, which after a growth
+     * is about one over the maximum load factor. Robin Hood tables always resize at once.
+     */
+    unsigned long long int rehash_step;
+
+    /**
+     * @brief The sizing policy of the bucket array, MADS_HASH_TABLE_SIZING_PRIME (the default)
+     * or MADS_HASH_TABLE_SIZING_POW2. Under either policy the hashing function receives a
+     * universal hash created by mads_uni_hash_create_pow2 with MADS_HASH_TABLE_HASH_RANGE as its table size.
+     */
+    int sizing;
+
+    /**
+     * @brief The load factor below which a removal shrinks the table, zero (the default) to never shrink.
+     * The table shrinks to about half the maximum load factor, well above this low-water mark, so
+     * an insertion right after a shrink does not grow it again. It must stay below a quarter of
+     * the maximum load factor, and the table never shrinks below its initial size.
+     */
+    double min_load_factor;
+
+    /**
+     * @brief The load factor above which an insertion grows the table, MADS_HASH_TABLE_MAX_LOAD_FACTOR by default.
+     * Chained tables accept values above one, trading longer chains for fewer buckets. Robin Hood
+     * tables need a free slot to end every probe, so their maximum load factor must stay below one,
+     * and they grow before their last free slot is taken even if the load factor allows it.
+     */
+    double max_load_factor;
+
+    /**
+     * @brief The factor by which the size is multiplied when the table grows, MADS_HASH_TABLE_GROWTH_FACTOR by default.
+     * It must be greater than one. Power of two tables round the grown size up to a power of two.
+     */
+    double growth_factor;
+
+    /**
+     * @brief The hashing function for byte slice keys, NULL (the default) to disable mads_hash_table_find_by.
+     * A slice must hash to the same value as the stored key it equals, e.g. mads_hash_bytes
+     * alongside mads_hash_string.
+     */
+    mads_hash_table_hash_by_fn hash_by;
+
+    /**
+     * @brief The comparator between stored keys and byte slice keys, NULL (the default) to disable mads_hash_table_find_by.
+     * It must order the keys like the comparator of the cues, since tree buckets are searched with it.
+     */
+    mads_hash_table_compare_by_fn compare_by;
+
+    /**
+     * @brief One to store every inserted pair even if its key already exists, zero (the default) to keep keys unique.
+     * The pairs of a key are kept next to each other, in their bucket or in consecutive slots, and are
+     * visited with mads_hash_table_equal_range. Lookups and removals act on the first pair of the key.
+     * Tree buckets keep their keys unique, so a multimap uses MADS_HASH_TABLE_CHAIN_LIST or
+     * MADS_HASH_TABLE_OPEN_ROBIN_HOOD, not MADS_HASH_TABLE_CHAIN_TREE or MADS_HASH_TABLE_CHAIN_HYBRID.
+     */
+    int multimap;
+} mads_hash_table_options_t;
+
 
 /**
  * @brief Data structure representing a hash table.
+ * While an incremental resize is in progress the buckets of the old array from
+ * migrate_pos onwards have not been moved yet, and lookups consult them first.
+ * Every stored pair caches the hash code of its key, so a resize never calls the
+ * hashing function again and key comparisons are skipped on a hash code mismatch.
+ * A bucket is NULL until the first pair is inserted into it, and is treated as empty.
  */
 typedef struct
 {
     void **A; ///< @brief Pointers to memory blocks holding hash table elements.
-    int chain_type; ///< @brief The type of the separate chaining method (linked list or tree).
+    mads_hash_table_slot_t *slots; ///< @brief Flat slot array used by open addressing, NULL for separate chaining.
+    int chain_type; ///< @brief The type of the collision resolution method (linked list, tree, hybrid or open addressing).
     unsigned long long int n; ///< @brief The number of elements in the hash table.
     unsigned long long int size; ///< @brief The current memory size of the hash table.
     double load_factor; ///< @brief the load factor of the hash table.
-    mads_uni_hash_t *hfunc; ///< @brief A universal hashing function data structure.
+    mads_uni_hash_t *hfunc; ///< @brief A universal hashing function data structure, kept for the lifetime of the table.
     mads_hash_table_hash_fn hash; ///< @brief The user-defined hashing function for the key element.
+    mads_hash_table_options_t options; ///< @brief The options the hash table was created with.
+    void **old_A; ///< @brief The bucket array of an in-progress resize, NULL otherwise.
+    unsigned long long int old_size; ///< @brief The size of the old bucket array.
+    unsigned long long int migrate_pos; ///< @brief The index of the next old bucket to migrate.
+    unsigned char *trees; ///< @brief For hybrid tables, one flag per bucket set while the bucket is a tree, NULL otherwise.
+    unsigned char *old_trees; ///< @brief The tree flags of the old bucket array of an in-progress resize.
+    struct mads_hash_table_live_counters_t *counters; ///< @brief The operation counters, NULL unless the library is built with MADS_HASH_TABLE_STATS.
 } mads_hash_table_t;
 
 
+/**
+ * @brief Data structure representing an iterator over the pairs of a hash table.
+ * The iterator lives on the caller's side and allocates nothing. Any insertion or
+ * removal invalidates it; the values of the visited pairs may be changed freely.
+ */
+typedef struct
+{
+    const mads_hash_table_t *table; ///< @brief The hash table being iterated.
+    int in_old; ///< @brief One while walking the not yet migrated buckets of an in-progress resize.
+    unsigned long long int bucket; ///< @brief The index of the next bucket or slot to visit.
+    const void *node; ///< @brief The next linked list node of the current bucket, if any.
+    const void *stack[MADS_HASH_TABLE_ITER_STACK]; ///< @brief The pending tree nodes of the current bucket.
+    unsigned long long int depth; ///< @brief The number of pending tree nodes.
+} mads_hash_table_iter_t;
+
+
+/**
+ * @brief Data structure representing the run of pairs holding one key, see mads_hash_table_equal_range.
+ * Like the iterator it lives on the caller's side, and any insertion or removal invalidates it.
+ */
+typedef struct
+{
+    const mads_hash_table_t *table; ///< @brief The hash table holding the pairs.
+    const void *key; ///< @brief The key of the pairs.
+    unsigned long long int code; ///< @brief The hash code of the key.
+    mads_pair_t *pair; ///< @brief The next pair of the run, NULL once the run is exhausted.
+    const void *node; ///< @brief The linked list node holding the next pair, for list buckets.
+    unsigned long long int position; ///< @brief The slot holding the next pair, for Robin Hood tables.
+} mads_hash_table_range_t;
+
+
+/**
+ * @brief Data structure holding a snapshot of the operation counters of a hash table.
+ * The counters are only maintained when the library is built with the MADS_HASH_TABLE_STATS
+ * compile definition (the CMake option of the same name); otherwise every counter reads zero.
+ */
+typedef struct
+{
+    unsigned long long int lookups; ///< @brief The number of keys looked up by find, lookup, get_value and their batch variants.
+    unsigned long long int hits; ///< @brief The number of lookups that found their key.
+    unsigned long long int misses; ///< @brief The number of lookups that did not find their key.
+    unsigned long long int comparisons; ///< @brief The number of key comparator calls made by the bucket searches of the hash table.
+    unsigned long long int rehashes; ///< @brief The number of resizes, growing or shrinking.
+    unsigned long long int rehash_nanoseconds; ///< @brief The time spent resizing, including incremental migration steps.
+} mads_hash_table_counters_t;
+
+
+/**
+ * @brief Data structure holding the statistics of a hash table, to tune its options from data.
+ * For Robin Hood tables the chain of a pair is its probe sequence: a pair stored at its home slot
+ * has a chain length of one, and every slot it has been displaced adds one.
+ */
+typedef struct
+{
+    unsigned long long int n; ///< @brief The number of elements in the hash table.
+    unsigned long long int size; ///< @brief The number of buckets (or slots) of the hash table.
+    double load_factor; ///< @brief The load factor of the hash table.
+    unsigned long long int used_buckets; ///< @brief The number of buckets holding at least one pair.
+    double average_chain_length; ///< @brief The average number of pairs in a used bucket, or the average probe length.
+    unsigned long long int max_chain_length; ///< @brief The largest number of pairs in a bucket, or the longest probe.
+    unsigned long long int histogram[MADS_HASH_TABLE_STATS_HISTOGRAM]; ///< @brief The number of buckets (or slots) per chain length, empty ones in bin zero.
+    mads_hash_table_counters_t counters; ///< @brief The operation counters at the time of the call.
+} mads_hash_table_stats_t;
+
+
+/**
+ * @brief A visitor function for the pairs of a hash table.
+ * @param[in] Pointer to the visited pair.
+ * @param[in] Pointer to the user context given to mads_hash_table_for_each.
+ */
+typedef void (*mads_hash_table_visit_fn)(mads_pair_t *, void *);
+
+
 /**
  * @brief Function to create a new hash table.
  * @param[in] hash The hashing function for the key element.
- * @param[in] chain_type The type of the separate chaining method.
+ * @param[in] chain_type The type of the collision resolution method. One of MADS_HASH_TABLE_CHAIN_LIST,
+ * MADS_HASH_TABLE_CHAIN_TREE, MADS_HASH_TABLE_CHAIN_HYBRID or MADS_HASH_TABLE_OPEN_ROBIN_HOOD.
  * @return Pointer to created hash table.
  */
 MADS_EXPORT mads_hash_table_t *mads_hash_table_create(mads_hash_table_hash_fn hash, int chain_type);
 
+/**
+ * @brief Function to get the default options of a hash table.
+ * @return The default hash table options.
+ */
+MADS_EXPORT mads_hash_table_options_t mads_hash_table_default_options(void);
+
+/**
+ * @brief Function to create a new hash table with the given options.
+ * @param[in] hash The hashing function for the key element.
+ * @param[in] chain_type The type of the collision resolution method. One of MADS_HASH_TABLE_CHAIN_LIST,
+ * MADS_HASH_TABLE_CHAIN_TREE, MADS_HASH_TABLE_CHAIN_HYBRID or MADS_HASH_TABLE_OPEN_ROBIN_HOOD.
+ * @param[in] options The options of the hash table. If NULL the default options are used.
+ * @return Pointer to created hash table.
+ */
+MADS_EXPORT mads_hash_table_t *mads_hash_table_create_with_options(mads_hash_table_hash_fn hash,
+    int chain_type,
+    const mads_hash_table_options_t *options);
+
+/**
+ * @brief Function to create a new hash table sized for an expected number of elements.
+ * The bucket array and the universal hashing function are created once, so inserting up to
+ * capacity elements does not trigger any resize.
+ * @param[in] hash The hashing function for the key element.
+ * @param[in] chain_type The type of the collision resolution method. One of MADS_HASH_TABLE_CHAIN_LIST,
+ * MADS_HASH_TABLE_CHAIN_TREE, MADS_HASH_TABLE_CHAIN_HYBRID or MADS_HASH_TABLE_OPEN_ROBIN_HOOD.
+ * @param[in] capacity The expected number of elements.
+ * @param[in] options The options of the hash table, whose maximum load factor sizes the bucket array.
+ * If NULL the default options are used.
+ * @return Pointer to created hash table.
+ */
+MADS_EXPORT mads_hash_table_t *mads_hash_table_create_with_capacity(mads_hash_table_hash_fn hash,
+    int chain_type,
+    unsigned long long int capacity,
+    const mads_hash_table_options_t *options);
+
+/**
+ * @brief Function to grow the hash table so that it holds the given number of elements without resizing.
+ * The table is resized at most once and all pairs are moved at once, regardless of the rehash step.
+ * A table that is already large enough is left untouched.
+ * @param[in,out] t The hash table to grow.
+ * @param[in] capacity The expected number of elements.
+ */
+MADS_EXPORT void mads_hash_table_reserve(mads_hash_table_t *t, unsigned long long int capacity);
+
+/**
+ * @brief Function to shrink the hash table to the smallest size holding its elements within the maximum load factor.
+ * The table never shrinks below its initial size, and all pairs are moved at once, regardless of the rehash step.
+ * @param[in,out] t The hash table to shrink.
+ */
+MADS_EXPORT void mads_hash_table_shrink_to_fit(mads_hash_table_t *t);
+
+/**
+ * @brief Function to compute the statistics of the hash table. It walks every bucket, so its cost is linear.
+ * The buckets of an in-progress incremental resize that have not been migrated yet are included.
+ * @param[in] t The hash table to inspect.
+ * @return The statistics of the hash table.
+ */
+MADS_EXPORT mads_hash_table_stats_t mads_hash_table_stats(const mads_hash_table_t *t);
+
+/**
+ * @brief Function to read the operation counters of the hash table. It is cheap and may run alongside lookups.
+ * @param[in] t The hash table to inspect.
+ * @return The operation counters, all zero unless the library is built with MADS_HASH_TABLE_STATS.
+ */
+MADS_EXPORT mads_hash_table_counters_t mads_hash_table_get_counters(const mads_hash_table_t *t);
+
+/**
+ * @brief Function to reset the operation counters of the hash table to zero.
+ * @param[in] t The hash table whose counters are reset.
+ */
+MADS_EXPORT void mads_hash_table_reset_counters(const mads_hash_table_t *t);
+
 /**
  * @brief Function to insert a (key, value) pair into the hash table.
+ * Unless the table is a multimap, the pair is dropped if its key already exists.
  * @param[in,out] t The hash table to insert into.
  * @param[in] p The key value pair to add.
  */
 MADS_EXPORT void mads_hash_table_insert(mads_hash_table_t *t, mads_pair_t *p);
 
+/**
+ * @brief Function to insert an array of (key, value) pairs into the hash table.
+ * The pairs are processed in groups of MADS_HASH_TABLE_BATCH_GROUP: all keys of a group are hashed
+ * and their buckets prefetched before any of them is inserted, hiding most of the memory latency.
+ * @param[in,out] t The hash table to insert into.
+ * @param[in] pairs The key value pairs to add. A pair whose key already exists is not inserted and remains owned by the caller.
+ * @param[in] count The number of pairs.
+ * @param[out] inserted Optional, may be NULL. An array of count flags, each set to one if the pair was inserted, zero otherwise.
+ */
+MADS_EXPORT void mads_hash_table_insert_batch(mads_hash_table_t *t, mads_pair_t **pairs, unsigned long long int count, int *inserted);
+
+/**
+ * @brief Function to find the pair holding the key of the given pair, inserting the pair if the key does not exist.
+ * The key is hashed once and its bucket is traversed once, so it replaces a lookup followed by an insert.
+ * A multimap inserts every pair, next to the pairs already holding its key.
+ * @param[in,out] t The hash table to insert into.
+ * @param[in] p The key value pair to add. If its key already exists the pair is not inserted and remains owned by the caller.
+ * @param[out] inserted Optional, may be NULL. Set to one if the pair was inserted, zero otherwise.
+ * @return The pair stored in the hash table for the key, which is the given pair if it was inserted.
+ */
+MADS_EXPORT mads_pair_t *mads_hash_table_find_or_insert(mads_hash_table_t *t, mads_pair_t *p, int *inserted);
+
+/**
+ * @brief Function to find the pair holding the given key.
+ * The key is hashed once and its bucket is traversed once. The returned pair is a handle to the
+ * entry, so its value can be read or replaced (e.g. with mads_pair_change_value) without another lookup.
+ * @param[in] t The hash table to perform the lookup.
+ * @param[in] key The key element to search for.
+ * @return The pair stored in the hash table for the key, or NULL if the key does not exist.
+ */
+MADS_EXPORT mads_pair_t *mads_hash_table_find(const mads_hash_table_t *t, const void *key);
+
 /**
  * @brief Function to look up the hash table for the given key.
  * @param[in] t The hash table to perform the lookup.
@@ -87,8 +465,63 @@ MADS_EXPORT void mads_hash_table_insert(mads_hash_table_t *t, mads_pair_t *p);
  */
 MADS_EXPORT int mads_hash_table_lookup(const mads_hash_table_t *t, void *key);
 
+/**
+ * @brief Function to start visiting the pairs holding the given key, which sit next to each other in a multimap.
+ * The key is hashed once; each call to mads_hash_table_range_next then returns one pair of the run.
+ * In a table with unique keys the run holds at most one pair.
+ * @param[in] t The hash table to search.
+ * @param[in] key The key element to search for.
+ * @param[out] range The range to initialize.
+ */
+MADS_EXPORT void mads_hash_table_equal_range(const mads_hash_table_t *t, const void *key, mads_hash_table_range_t *range);
+
+/**
+ * @brief Function to get the next pair of a range started by mads_hash_table_equal_range.
+ * @param[in,out] range The range to advance.
+ * @return The next pair holding the key, or NULL once every pair has been visited.
+ */
+MADS_EXPORT mads_pair_t *mads_hash_table_range_next(mads_hash_table_range_t *range);
+
+/**
+ * @brief Function to count the pairs holding the given key.
+ * @param[in] t The hash table to search.
+ * @param[in] key The key element to search for.
+ * @return The number of pairs holding the key, at most one unless the table is a multimap.
+ */
+MADS_EXPORT unsigned long long int mads_hash_table_count(const mads_hash_table_t *t, const void *key);
+
+/**
+ * @brief Function to find the pair whose key equals a borrowed byte slice, e.g. a substring of a larger buffer.
+ * The slice is hashed and compared in place with the hash_by and compare_by options, which must be
+ * set, so no key or pair is built for the lookup and each probed pair costs at most one comparator call.
+ * @param[in] t The hash table to perform the lookup.
+ * @param[in] key Pointer to the first byte of the slice, which need not be NUL-terminated.
+ * @param[in] length The number of bytes in the slice.
+ * @return The pair stored in the hash table for the key, or NULL if the key does not exist.
+ */
+MADS_EXPORT mads_pair_t *mads_hash_table_find_by(const mads_hash_table_t *t, const void *key, unsigned long long int length);
+
+/**
+ * @brief Function to look up the hash table for a borrowed byte slice key, see mads_hash_table_find_by.
+ * @param[in] t The hash table to perform the lookup.
+ * @param[in] key Pointer to the first byte of the slice.
+ * @param[in] length The number of bytes in the slice.
+ * @return One if the key already exists, zero otherwise.
+ */
+MADS_EXPORT int mads_hash_table_lookup_by(const mads_hash_table_t *t, const void *key, unsigned long long int length);
+
+/**
+ * @brief Function to retrieve the value associated with a borrowed byte slice key, see mads_hash_table_find_by.
+ * @param[in] t The hash table from which to retrieve the value.
+ * @param[in] key Pointer to the first byte of the slice.
+ * @param[in] length The number of bytes in the slice.
+ * @return The value associated with the key, or NULL if the key does not exist.
+ */
+MADS_EXPORT void *mads_hash_table_get_value_by(const mads_hash_table_t *t, const void *key, unsigned long long int length);
+
 /**
  * @brief Function to remove a (key, value) pair from the hash table.
+ * A multimap removes the first pair holding the key.
  * @param[in,out] t The hash table from which to remove.
  * @param[int] key The key element to be removed.
  */
@@ -102,6 +535,17 @@ MADS_EXPORT void mads_hash_table_remove(mads_hash_table_t *t, void *key);
  */
 MADS_EXPORT void *mads_hash_table_get_value(const mads_hash_table_t *t, void *key);
 
+/**
+ * @brief Function to retrieve the values associated with an array of keys from the hash table.
+ * The keys are processed in groups of MADS_HASH_TABLE_BATCH_GROUP: all keys of a group are hashed
+ * and their buckets prefetched before any of them is resolved, hiding most of the memory latency.
+ * @param[in] t The hash table from which to retrieve the values.
+ * @param[in] keys The key elements whose values we must retrieve.
+ * @param[in] count The number of keys.
+ * @param[out] values An array of count values, each set to the value of the corresponding key, or NULL if the key does not exist.
+ */
+MADS_EXPORT void mads_hash_table_get_values_batch(const mads_hash_table_t *t, void **keys, unsigned long long int count, void **values);
+
 /**
  * @brief Function to change the value associated with the given key element into the hash table.
  * @param[in,out] t The hash table from which to change the value element of the given key.
@@ -112,11 +556,44 @@ MADS_EXPORT void mads_hash_table_change_value(const mads_hash_table_t *t, void *
 
 
 /**
- * @brief Function to clear the hash table.
+ * @brief Function to clear the hash table, freeing every pair it holds.
+ * The bucket array, the bucket containers allocated so far and the hashing function stay allocated,
+ * so refilling a cleared table up to its previous size allocates little more than the new pairs.
  * @param[in,out] t Hash table data structure to be cleared.
  */
 MADS_EXPORT void mads_hash_table_clear(mads_hash_table_t *t);
 
+/**
+ * @brief Function to clear the hash table and shrink its bucket array back to the initial size.
+ * The bucket containers that fit in the shrunk array are kept allocated, the others are released.
+ * @param[in,out] t Hash table data structure to be cleared.
+ */
+MADS_EXPORT void mads_hash_table_clear_and_shrink(mads_hash_table_t *t);
+
+/**
+ * @brief Function to initialize an iterator over the pairs of the hash table.
+ * The pairs are visited in no particular order.
+ * @param[out] it The iterator to initialize.
+ * @param[in] t The hash table to iterate.
+ */
+MADS_EXPORT void mads_hash_table_iter_init(mads_hash_table_iter_t *it, const mads_hash_table_t *t);
+
+/**
+ * @brief Function to advance an iterator to the next pair of the hash table.
+ * @param[in,out] it The iterator to advance.
+ * @return The next pair, or NULL once every pair has been visited.
+ */
+MADS_EXPORT mads_pair_t *mads_hash_table_iter_next(mads_hash_table_iter_t *it);
+
+/**
+ * @brief Function to call the given visitor on every pair of the hash table.
+ * The visitor must not insert into or remove from the hash table.
+ * @param[in] t The hash table to traverse.
+ * @param[in] fn The visitor function.
+ * @param[in] ctx User context passed to every call of the visitor, may be NULL.
+ */
+MADS_EXPORT void mads_hash_table_for_each(const mads_hash_table_t *t, mads_hash_table_visit_fn fn, void *ctx);
+
 /**
  * @brief Function to print the contents of the hash table.
  * @param[in] t The hash table whose contents will be printed.
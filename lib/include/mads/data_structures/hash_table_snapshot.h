@@ -0,0 +1,108 @@
+// ReSharper disable CppDoxygenUnresolvedReference
+
+/**
+ * @file hash_table_snapshot.h
+ * @brief This header file provides an API for saving a hash table to a binary snapshot file and
+ * answering lookups straight from a read-only memory mapping of that file.
+ * The snapshot applies to tables whose keys and values are plain byte blobs: the caller tells the
+ * writer the length of every key and value, and the bytes are copied into the file as they are.
+ *
+ * The file starts with a header holding the number of pairs, the number of buckets (a power of
+ * two) and the seeds of the hashing function, followed by the byte offset of every bucket and
+ * the entries themselves, grouped by bucket. An entry holds the 64-bit hash of its key, the key
+ * and value lengths and the key and value bytes, padded to eight bytes. Keys are hashed with
+ * mads_hash_bytes under the seeds stored in the file, so lookups do not depend on the process
+ * that wrote it. Loading maps the file and validates its header, without reading or allocating
+ * anything per entry. Numbers are stored in native byte order, so a snapshot is read on a
+ * machine of the same endianness as the one that wrote it.
+ */
+
+#ifndef MADS_DATA_STRUCTURES_HASH_TABLE_SNAPSHOT_H
+#define MADS_DATA_STRUCTURES_HASH_TABLE_SNAPSHOT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def MADS_HASH_TABLE_SNAPSHOT_MAGIC
+ * @brief A macro constant holding the eight bytes every snapshot file starts with, including the format version.
+ */
+#define MADS_HASH_TABLE_SNAPSHOT_MAGIC "MADSHTS1"
+
+#include <mads_export.h>
+#include <mads/data_structures/uni_hash.h>
+#include <mads/data_structures/hash_table.h>
+
+
+/**
+ * @brief A function returning the length in bytes of a key or value blob of the hash table.
+ * @param[in] GenericPointer to the key or value data, as stored in the cue or value of a pair.
+ * @return The number of bytes of the blob, e.g. strlen + 1 for NUL-terminated strings.
+ */
+typedef unsigned long long int (*mads_hash_table_blob_size_fn)(const void *);
+
+
+/**
+ * @brief Data structure representing a loaded, read-only hash table snapshot.
+ */
+typedef struct
+{
+    const unsigned char *data; ///< @brief The memory mapping of the whole snapshot file.
+    unsigned long long int length; ///< @brief The length of the mapping in bytes.
+    unsigned long long int n; ///< @brief The number of pairs in the snapshot.
+    unsigned long long int buckets; ///< @brief The number of buckets, a power of two.
+    const unsigned long long int *offsets; ///< @brief The byte offset of every bucket within the entries, plus the end offset.
+    const unsigned char *entries; ///< @brief The entries of the snapshot, grouped by bucket.
+    unsigned long long int entries_length; ///< @brief The length of the entries in bytes.
+    mads_uni_hash_t hfunc; ///< @brief The hashing function, carrying the seeds stored in the file.
+} mads_hash_table_snapshot_t;
+
+
+/**
+ * @brief Function to write the pairs of a hash table to a snapshot file.
+ * The table is not modified. An existing file at the path is overwritten.
+ * @param[in] t The hash table to save.
+ * @param[in] path The path of the snapshot file.
+ * @param[in] key_size The function returning the length of every key blob.
+ * @param[in] value_size The function returning the length of every value blob.
+ * @return One if the snapshot was written, zero if the file could not be created or written.
+ */
+MADS_EXPORT int mads_hash_table_snapshot_write(const mads_hash_table_t *t,
+    const char *path,
+    mads_hash_table_blob_size_fn key_size,
+    mads_hash_table_blob_size_fn value_size);
+
+/**
+ * @brief Function to load a snapshot file by mapping it into memory, read only.
+ * @param[in] path The path of the snapshot file.
+ * @return Pointer to the loaded snapshot, or NULL if the file cannot be mapped or is not a valid snapshot.
+ */
+MADS_EXPORT mads_hash_table_snapshot_t *mads_hash_table_snapshot_load(const char *path);
+
+/**
+ * @brief Function to look up a key in a loaded snapshot. Nothing is allocated or copied.
+ * @param[in] s The snapshot to search.
+ * @param[in] key Pointer to the key bytes.
+ * @param[in] key_length The number of key bytes.
+ * @param[out] value_length Receives the number of value bytes when the key is found, may be NULL.
+ * @return Pointer to the value bytes inside the mapping, valid until the snapshot is freed, or NULL if the key does not exist.
+ */
+MADS_EXPORT const void *mads_hash_table_snapshot_find(const mads_hash_table_snapshot_t *s,
+    const void *key,
+    unsigned long long int key_length,
+    unsigned long long int *value_length);
+
+/**
+ * @brief Function to unmap a loaded snapshot and release its memory.
+ * @param[in,out] s The snapshot to be freed.
+ */
+MADS_EXPORT void mads_hash_table_snapshot_free(mads_hash_table_snapshot_t **s);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif //MADS_DATA_STRUCTURES_HASH_TABLE_SNAPSHOT_H
@@ -124,6 +124,16 @@ MADS_EXPORT void mads_list_append(mads_list_t *list, void *data);
 */
 MADS_EXPORT void mads_list_insert_at(mads_list_t *list, void *data, unsigned long long int position);
 
+/**
+* @brief Inserts a new element right after the given node of the list
+* @details This function creates a new node with the provided data and links it after a node the caller already holds,
+* so the list does not have to be walked to the insertion point.
+* @param [in] list The list where the new element should be inserted
+* @param [in] node The node after which the new element is inserted, which must belong to the list
+* @param [in] data The data to be stored in the new node
+*/
+MADS_EXPORT void mads_list_insert_after(mads_list_t *list, mads_llnode_t *node, void *data);
+
 /**
 * @brief Returns the element at the head of the list
 * @param [in] list The list whose head element should be returned
@@ -177,6 +187,16 @@ MADS_EXPORT void mads_list_remove_foot(mads_list_t *list);
 */
 MADS_EXPORT void mads_list_remove_at(mads_list_t *list, unsigned long long int position);
 
+/**
+* @brief This function removes the given node from the list.
+* @details This function takes in a list and one of its nodes, unlinks the node by adjusting the `next` and
+*          `previous` pointers of the adjacent nodes, and frees it. No traversal of the list is needed.
+* @param list The list from which to remove the node.
+* @param node The node to be removed, which must belong to the list.
+* @return void
+*/
+MADS_EXPORT void mads_list_remove_node(mads_list_t *list, mads_llnode_t *node);
+
 /**
 * @brief This function prints all the elements in the list.
 * @param list The list whose elements are to be printed.
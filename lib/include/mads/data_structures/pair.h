@@ -127,6 +127,7 @@ typedef struct
 {
     mads_cue_t *k; ///< @brief The key of the pair
     mads_value_t *v; ///< @brief The value of the pair
+    unsigned long long int hash; ///< @brief The hash code of the key, cached by the hash table holding the pair
 } mads_pair_t;
 
 
@@ -0,0 +1,117 @@
+// ReSharper disable CppDoxygenUnresolvedReference
+
+/**
+ * @file static_map.h
+ * @brief This header file provides an API for an immutable map built over a minimal perfect hash.
+ * The map is built once from the current contents of a hash table with the CHD (compress, hash and
+ * displace) algorithm. The keys are split into small buckets by a first universal hash, and every
+ * bucket gets a displacement (d0, d1) that sends each of its keys to the slot
+ *
+ *      (f1(key) + d0 * f2(key) + d1) mod n
+ *
+ * where f1 and f2 are two further universal hashes. The displacements are searched bucket by bucket,
+ * the largest buckets first, until every key owns a slot of its own. The result has exactly one slot
+ * per key: a lookup hashes the key three times and compares it with a single stored pair, and there
+ * are no chains or empty slots to store.
+ *
+ * The three hashes are drawn from the mads_uni_hash_t family and evaluated with the hashing function
+ * of the source table, so the map fits every key type the hash table supports. The map borrows the
+ * pairs of the source table: the table must outlive the map and must not be modified meanwhile.
+ * Built from a multimap, the map holds only the first pair of every key, the one mads_hash_table_find returns.
+ */
+
+#ifndef MADS_DATA_STRUCTURES_STATIC_MAP_H
+#define MADS_DATA_STRUCTURES_STATIC_MAP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def MADS_STATIC_MAP_BUCKET_SIZE
+ * @brief A macro constant to specify the average number of keys per bucket of the first hash.
+ * Larger buckets take less memory for the displacements but longer to place.
+ */
+#define MADS_STATIC_MAP_BUCKET_SIZE 4
+
+/**
+ * @def MADS_STATIC_MAP_MAX_D0
+ * @brief A macro constant to specify the number of d0 values tried for a bucket before the hashes are redrawn.
+ */
+#define MADS_STATIC_MAP_MAX_D0 256
+
+/**
+ * @def MADS_STATIC_MAP_MAX_ATTEMPTS
+ * @brief A macro constant to specify the number of times the hashes are redrawn before the build gives up.
+ */
+#define MADS_STATIC_MAP_MAX_ATTEMPTS 64
+
+#include <mads_export.h>
+#include <mads/data_structures/uni_hash.h>
+#include <mads/data_structures/pair.h>
+#include <mads/data_structures/hash_table.h>
+
+
+/**
+ * @brief Data structure representing an immutable map over a minimal perfect hash.
+ */
+typedef struct
+{
+    mads_pair_t **slots; ///< @brief The borrowed pairs, one slot per key.
+    unsigned long long int n; ///< @brief The number of elements, which is also the number of slots.
+    unsigned long long int *displacements; ///< @brief The displacement of every bucket, stored as d0 * n + d1.
+    unsigned long long int buckets; ///< @brief The number of buckets of the first hash.
+    mads_uni_hash_t *h0; ///< @brief The universal hash splitting the keys into buckets.
+    mads_uni_hash_t *h1; ///< @brief The universal hash giving the base slot f1 of a key.
+    mads_uni_hash_t *h2; ///< @brief The universal hash giving the step f2 of a key.
+    mads_hash_table_hash_fn hash; ///< @brief The user-defined hashing function for the key element.
+} mads_static_map_t;
+
+
+/**
+ * @brief Function to build a static map over the current pairs of a hash table.
+ * The build asserts if no perfect hash is found after MADS_STATIC_MAP_MAX_ATTEMPTS draws of the
+ * hashes, which only happens when the hashing function sends distinct keys to identical values.
+ * Equal keys of a multimap do not count: only the first pair of each key is kept.
+ * @param[in] t The hash table whose pairs are borrowed by the map.
+ * @return Pointer to the created static map.
+ */
+MADS_EXPORT mads_static_map_t *mads_static_map_build(const mads_hash_table_t *t);
+
+/**
+ * @brief Function to find the pair holding the given key in the static map, with a single probe.
+ * @param[in] m The static map to search.
+ * @param[in] key The key element to search for.
+ * @return The pair holding the key, or NULL if the key does not exist.
+ */
+MADS_EXPORT mads_pair_t *mads_static_map_find(const mads_static_map_t *m, const void *key);
+
+/**
+ * @brief Function to look up the static map for the given key.
+ * @param[in] m The static map to perform the lookup.
+ * @param[in] key The key element to search for.
+ * @return One if the key exists, zero otherwise.
+ */
+MADS_EXPORT int mads_static_map_lookup(const mads_static_map_t *m, const void *key);
+
+/**
+ * @brief Function to retrieve the value associated with the given key element from the static map.
+ * @param[in] m The static map from which to retrieve the value element of the given key.
+ * @param[in] key The key element whose value we must retrieve.
+ * @return The value associated with the given key, or NULL if the key does not exist.
+ */
+MADS_EXPORT void *mads_static_map_get_value(const mads_static_map_t *m, const void *key);
+
+/**
+ * @brief Function to free the static map. The borrowed pairs stay owned by the source hash table.
+ * @param[in,out] m The static map to be freed.
+ */
+MADS_EXPORT void mads_static_map_free(mads_static_map_t **m);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif //MADS_DATA_STRUCTURES_STATIC_MAP_H
@@ -0,0 +1,173 @@
+// ReSharper disable CppDoxygenUnresolvedReference
+
+/**
+ * @file typed_array.h
+ * @brief This header file provides a macro generating dynamic arrays of a given element type.
+ * Unlike mads_array_t, which holds pointers to separately allocated elements, a generated array stores
+ * its elements by value in one contiguous block: an array of integers or small structs costs no
+ * allocation per element and no pointer chasing. The generated functions are static inline and
+ * specialized for the element type, so there are no comparator, printer or destructor callbacks.
+ *
+ * Usage, at file scope:
+ *
+ *      MADS_DEFINE_ARRAY(int_array, int)
+ *
+ *      int_array_t *array = int_array_create();
+ *      int_array_append(array, 42);
+ *      int x = int_array_get_at(array, 0);
+ *      int_array_free(&array);
+ *
+ * Elements are copied in and out with plain assignment, so an element type holding pointers does not
+ * transfer the ownership of the memory they point to: free it before removing the element.
+ */
+
+#ifndef MADS_DATA_STRUCTURES_TYPED_ARRAY_H
+#define MADS_DATA_STRUCTURES_TYPED_ARRAY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/**
+ * @def MADS_TYPED_ARRAY_INITIAL_SIZE
+ * @brief A macro constant to specify the number of elements a generated array has room for when created.
+ */
+#define MADS_TYPED_ARRAY_INITIAL_SIZE 16
+
+
+/**
+ * @def MADS_DEFINE_ARRAY(name, T)
+ * @brief A macro generating the type name_t, a dynamic array of elements of type T, and its functions:
+ *
+ * - name_t *name_create(void): creates an empty array.
+ * - void name_reserve(name_t *array, size_t capacity): makes room for capacity elements.
+ * - void name_append(name_t *array, T value), void name_prepend(name_t *array, T value).
+ * - void name_insert_at(name_t *array, size_t index, T value): inserts before the index, up to the size.
+ * - void name_remove_at(name_t *array, size_t index).
+ * - T name_get_at(const name_t *array, size_t index), void name_set_at(name_t *array, size_t index, T value).
+ * - T *name_at(const name_t *array, size_t index): the address of an element, valid until the array grows.
+ * - T *name_data(const name_t *array), size_t name_size(const name_t *array), int name_is_empty(const name_t *array).
+ * - void name_clear(name_t *array), void name_free(name_t **array).
+ *
+ * Out of range indices fail an assertion, like the rest of the library.
+ * @param name The prefix of the generated type and functions.
+ * @param T The element type.
+ */
+#define MADS_DEFINE_ARRAY(name, T) \
+    typedef struct \
+    { \
+        T *data; \
+        size_t size; \
+        size_t memsize; \
+    } name##_t; \
+    \
+    static inline name##_t *name##_create(void) \
+    { \
+        name##_t *new_array = (name##_t *)malloc(sizeof(*new_array)); \
+        assert(new_array != NULL); \
+        new_array->data = (T *)malloc(MADS_TYPED_ARRAY_INITIAL_SIZE * sizeof(T)); \
+        assert(new_array->data != NULL); \
+        new_array->size = 0; \
+        new_array->memsize = MADS_TYPED_ARRAY_INITIAL_SIZE; \
+        return new_array; \
+    } \
+    \
+    static inline void name##_reserve(name##_t *array, const size_t capacity) \
+    { \
+        assert(array != NULL); \
+        if (capacity <= array->memsize) { return; } \
+        T *new_data = (T *)realloc(array->data, capacity * sizeof(T)); \
+        assert(new_data != NULL); \
+        array->data = new_data; \
+        array->memsize = capacity; \
+    } \
+    \
+    static inline void name##_insert_at(name##_t *array, const size_t index, const T value) \
+    { \
+        assert(array != NULL && index <= array->size); \
+        if (array->size == array->memsize) { name##_reserve(array, array->memsize * 2); } \
+        memmove(&array->data[index + 1], &array->data[index], (array->size - index) * sizeof(T)); \
+        array->data[index] = value; \
+        array->size = array->size + 1; \
+    } \
+    \
+    static inline void name##_append(name##_t *array, const T value) \
+    { \
+        assert(array != NULL); \
+        if (array->size == array->memsize) { name##_reserve(array, array->memsize * 2); } \
+        array->data[array->size] = value; \
+        array->size = array->size + 1; \
+    } \
+    \
+    static inline void name##_prepend(name##_t *array, const T value) \
+    { \
+        name##_insert_at(array, 0, value); \
+    } \
+    \
+    static inline void name##_remove_at(name##_t *array, const size_t index) \
+    { \
+        assert(array != NULL && index < array->size); \
+        memmove(&array->data[index], &array->data[index + 1], (array->size - index - 1) * sizeof(T)); \
+        array->size = array->size - 1; \
+    } \
+    \
+    static inline T *name##_at(const name##_t *array, const size_t index) \
+    { \
+        assert(array != NULL && index < array->size); \
+        return &array->data[index]; \
+    } \
+    \
+    static inline T name##_get_at(const name##_t *array, const size_t index) \
+    { \
+        return *name##_at(array, index); \
+    } \
+    \
+    static inline void name##_set_at(name##_t *array, const size_t index, const T value) \
+    { \
+        *name##_at(array, index) = value; \
+    } \
+    \
+    static inline T *name##_data(const name##_t *array) \
+    { \
+        assert(array != NULL); \
+        return array->data; \
+    } \
+    \
+    static inline size_t name##_size(const name##_t *array) \
+    { \
+        assert(array != NULL); \
+        return array->size; \
+    } \
+    \
+    static inline int name##_is_empty(const name##_t *array) \
+    { \
+        assert(array != NULL); \
+        return (array->size == 0 ? 1 : 0); \
+    } \
+    \
+    static inline void name##_clear(name##_t *array) \
+    { \
+        assert(array != NULL); \
+        array->size = 0; \
+    } \
+    \
+    static inline void name##_free(name##_t **array) \
+    { \
+        assert(array != NULL && *array != NULL); \
+        free((*array)->data); \
+        (*array)->data = NULL; \
+        free(*array); \
+        *array = NULL; \
+    }
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //MADS_DATA_STRUCTURES_TYPED_ARRAY_H
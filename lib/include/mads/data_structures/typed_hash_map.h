@@ -0,0 +1,283 @@
+// ReSharper disable CppDoxygenUnresolvedReference
+
+/**
+ * @file typed_hash_map.h
+ * @brief This header file provides a macro generating hash maps of given key and value types.
+ * Unlike mads_hash_table_t, whose every entry is a pair pointing to a separately allocated cue and
+ * value, a generated map stores its keys and values by value, inline in one flat array of slots:
+ * an entry costs no allocation of its own. The hashing and equality functions are passed to the
+ * macro by name, so the compiler sees and inlines them instead of calling through pointers.
+ *
+ * Collisions are resolved by open addressing with Robin Hood linear probing, as in the
+ * MADS_HASH_TABLE_OPEN_ROBIN_HOOD tables, with backward shift deletion. Every slot records its
+ * distance from the home slot of its key, which marks empty slots and ends unsuccessful probes early.
+ * The number of slots is a power of two, and the home slot is taken from the top bits of the hash
+ * multiplied by a Fibonacci constant, so a weak hash such as the identity on integers still spreads.
+ *
+ * Usage, at file scope:
+ *
+ *      static unsigned long long int hash_id(const long long int key) { return (unsigned long long int)key; }
+ *      static int equal_id(const long long int a, const long long int b) { return a == b; }
+ *      MADS_DEFINE_HASH_MAP(counts, long long int, long long int, hash_id, equal_id)
+ *
+ *      counts_t *m = counts_create();
+ *      *counts_find_or_insert(m, 42, 0, NULL) += 1;
+ *      counts_free(&m);
+ */
+
+#ifndef MADS_DATA_STRUCTURES_TYPED_HASH_MAP_H
+#define MADS_DATA_STRUCTURES_TYPED_HASH_MAP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdlib.h>
+#include <assert.h>
+
+/**
+ * @def MADS_TYPED_HASH_MAP_INITIAL_SIZE
+ * @brief A macro constant to specify the initial number of slots of a generated map, a power of two.
+ */
+#define MADS_TYPED_HASH_MAP_INITIAL_SIZE 16
+
+/**
+ * @def MADS_TYPED_HASH_MAP_MAX_LOAD_PERCENT
+ * @brief A macro constant to specify the load, in percent of the slots, above which a generated map grows.
+ */
+#define MADS_TYPED_HASH_MAP_MAX_LOAD_PERCENT 85
+
+/**
+ * @def MADS_TYPED_HASH_MAP_FIBONACCI
+ * @brief A macro constant holding 2^64 divided by the golden ratio, the multiplier spreading the hashes over the slots.
+ */
+#define MADS_TYPED_HASH_MAP_FIBONACCI 11400714819323198485ULL
+
+
+/**
+ * @def MADS_DEFINE_HASH_MAP(name, K, V, hash, eq)
+ * @brief A macro generating the type name_t, a hash map from keys of type K to values of type V, and its functions:
+ *
+ * - name_t *name_create(void): creates an empty map.
+ * - void name_reserve(name_t *m, unsigned long long int capacity): makes room for capacity entries.
+ * - V *name_find_or_insert(name_t *m, K key, V value, int *inserted): returns the value of the key,
+ *   inserting the given value first if the key is missing. The optional inserted flag tells which happened.
+ * - int name_insert(name_t *m, K key, V value): inserts the entry unless the key exists, returning one if inserted.
+ * - V *name_find(const name_t *m, K key): returns the value of the key, or NULL if the key does not exist.
+ * - int name_lookup(const name_t *m, K key), int name_get(const name_t *m, K key, V *value).
+ * - int name_remove(name_t *m, K key): removes the key, returning one if it existed. The removal
+ *   shifts the following displaced entries one slot back, so no tombstones are left behind.
+ * - name_slot_t *name_next(const name_t *m, unsigned long long int *position): visits the entries,
+ *   starting from a position of zero, and returns NULL after the last one.
+ * - unsigned long long int name_size(const name_t *m), void name_clear(name_t *m), void name_free(name_t **m).
+ *
+ * Pointers to values stay valid until the next insertion or removal, which may move the entries.
+ * @param name The prefix of the generated types and functions.
+ * @param K The key type, copied with plain assignment.
+ * @param V The value type, copied with plain assignment.
+ * @param hash The name of a function taking a K and returning its unsigned long long int hash.
+ * @param eq The name of a function taking two K and returning nonzero if they are equal.
+ */
+#define MADS_DEFINE_HASH_MAP(name, K, V, hash, eq) \
+    typedef struct \
+    { \
+        K key; \
+        V value; \
+        unsigned int distance; \
+    } name##_slot_t; \
+    \
+    typedef struct \
+    { \
+        name##_slot_t *slots; \
+        unsigned long long int n; \
+        unsigned long long int capacity; \
+        unsigned int shift; \
+    } name##_t; \
+    \
+    static inline unsigned long long int name##_home(const name##_t *m, const K key) \
+    { \
+        return (hash(key) * MADS_TYPED_HASH_MAP_FIBONACCI) >> m->shift; \
+    } \
+    \
+    static inline void name##_allocate(name##_t *m, const unsigned long long int capacity) \
+    { \
+        unsigned int shift = 64; \
+        for (unsigned long long int c = capacity; c > 1; c = c >> 1) { shift--; } \
+        m->slots = (name##_slot_t *)calloc(capacity, sizeof(name##_slot_t)); \
+        assert(m->slots != NULL); \
+        m->capacity = capacity; \
+        m->shift = shift; \
+    } \
+    \
+    static inline name##_slot_t *name##_place(name##_t *m, name##_slot_t incoming, unsigned long long int position) \
+    { \
+        name##_slot_t *placed = NULL; \
+        while (m->slots[position].distance != 0) \
+        { \
+            if (m->slots[position].distance < incoming.distance) \
+            { \
+                const name##_slot_t temp_slot = m->slots[position]; \
+                m->slots[position] = incoming; \
+                incoming = temp_slot; \
+                if (placed == NULL) { placed = &m->slots[position]; } \
+            } \
+            position = (position + 1) & (m->capacity - 1); \
+            incoming.distance = incoming.distance + 1; \
+        } \
+        m->slots[position] = incoming; \
+        return (placed != NULL ? placed : &m->slots[position]); \
+    } \
+    \
+    static inline void name##_resize(name##_t *m, const unsigned long long int capacity) \
+    { \
+        name##_slot_t *old_slots = m->slots; \
+        const unsigned long long int old_capacity = m->capacity; \
+        name##_allocate(m, capacity); \
+        for (unsigned long long int i = 0; i < old_capacity; i++) \
+        { \
+            if (old_slots[i].distance == 0) { continue; } \
+            old_slots[i].distance = 1; \
+            name##_place(m, old_slots[i], name##_home(m, old_slots[i].key)); \
+        } \
+        free(old_slots); \
+    } \
+    \
+    static inline name##_t *name##_create(void) \
+    { \
+        name##_t *new_map = (name##_t *)malloc(sizeof(*new_map)); \
+        assert(new_map != NULL); \
+        name##_allocate(new_map, MADS_TYPED_HASH_MAP_INITIAL_SIZE); \
+        new_map->n = 0; \
+        return new_map; \
+    } \
+    \
+    static inline void name##_reserve(name##_t *m, const unsigned long long int capacity) \
+    { \
+        assert(m != NULL); \
+        unsigned long long int new_capacity = m->capacity; \
+        while (capacity * 100 > new_capacity * MADS_TYPED_HASH_MAP_MAX_LOAD_PERCENT) { new_capacity = new_capacity << 1; } \
+        if (new_capacity > m->capacity) { name##_resize(m, new_capacity); } \
+    } \
+    \
+    static inline unsigned long long int name##_locate(const name##_t *m, const K key) \
+    { \
+        assert(m != NULL); \
+        unsigned long long int position = name##_home(m, key); \
+        for (unsigned int distance = 1;; distance++) \
+        { \
+            const name##_slot_t *slot = &m->slots[position]; \
+            if (slot->distance < distance) { return m->capacity; } \
+            if (slot->distance == distance && eq(slot->key, key)) { return position; } \
+            position = (position + 1) & (m->capacity - 1); \
+        } \
+    } \
+    \
+    static inline V *name##_find(const name##_t *m, const K key) \
+    { \
+        const unsigned long long int position = name##_locate(m, key); \
+        return (position < m->capacity ? &m->slots[position].value : NULL); \
+    } \
+    \
+    static inline V *name##_find_or_insert(name##_t *m, const K key, const V value, int *inserted) \
+    { \
+        assert(m != NULL); \
+        name##_reserve(m, m->n + 1); \
+        unsigned long long int position = name##_home(m, key); \
+        unsigned int distance = 1; \
+        for (;; distance++) \
+        { \
+            name##_slot_t *slot = &m->slots[position]; \
+            if (slot->distance < distance) { break; } \
+            if (slot->distance == distance && eq(slot->key, key)) \
+            { \
+                if (inserted != NULL) { *inserted = 0; } \
+                return &slot->value; \
+            } \
+            position = (position + 1) & (m->capacity - 1); \
+        } \
+        name##_slot_t incoming; \
+        incoming.key = key; \
+        incoming.value = value; \
+        incoming.distance = distance; \
+        m->n = m->n + 1; \
+        if (inserted != NULL) { *inserted = 1; } \
+        return &name##_place(m, incoming, position)->value; \
+    } \
+    \
+    static inline int name##_insert(name##_t *m, const K key, const V value) \
+    { \
+        int inserted = 0; \
+        name##_find_or_insert(m, key, value, &inserted); \
+        return inserted; \
+    } \
+    \
+    static inline int name##_lookup(const name##_t *m, const K key) \
+    { \
+        return (name##_find(m, key) != NULL ? 1 : 0); \
+    } \
+    \
+    static inline int name##_get(const name##_t *m, const K key, V *value) \
+    { \
+        const V *found = name##_find(m, key); \
+        if (found == NULL) { return 0; } \
+        if (value != NULL) { *value = *found; } \
+        return 1; \
+    } \
+    \
+    static inline int name##_remove(name##_t *m, const K key) \
+    { \
+        unsigned long long int position = name##_locate(m, key); \
+        if (position == m->capacity) { return 0; } \
+        unsigned long long int next = (position + 1) & (m->capacity - 1); \
+        while (m->slots[next].distance > 1) \
+        { \
+            m->slots[position] = m->slots[next]; \
+            m->slots[position].distance = m->slots[position].distance - 1; \
+            position = next; \
+            next = (next + 1) & (m->capacity - 1); \
+        } \
+        m->slots[position].distance = 0; \
+        m->n = m->n - 1; \
+        return 1; \
+    } \
+    \
+    static inline name##_slot_t *name##_next(const name##_t *m, unsigned long long int *position) \
+    { \
+        assert(m != NULL && position != NULL); \
+        while (*position < m->capacity) \
+        { \
+            name##_slot_t *slot = &m->slots[*position]; \
+            *position = *position + 1; \
+            if (slot->distance != 0) { return slot; } \
+        } \
+        return NULL; \
+    } \
+    \
+    static inline unsigned long long int name##_size(const name##_t *m) \
+    { \
+        assert(m != NULL); \
+        return m->n; \
+    } \
+    \
+    static inline void name##_clear(name##_t *m) \
+    { \
+        assert(m != NULL); \
+        for (unsigned long long int i = 0; i < m->capacity; i++) { m->slots[i].distance = 0; } \
+        m->n = 0; \
+    } \
+    \
+    static inline void name##_free(name##_t **m) \
+    { \
+        assert(m != NULL && *m != NULL); \
+        free((*m)->slots); \
+        (*m)->slots = NULL; \
+        free(*m); \
+        *m = NULL; \
+    }
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //MADS_DATA_STRUCTURES_TYPED_HASH_MAP_H
@@ -21,6 +21,13 @@ extern "C" {
 #include <mads_export.h>
 
 
+/**
+ * @def MADS_UNI_HASH_SEEDS
+ * @brief A macro constant to specify the number of random 64-bit seeds of a universal hash.
+ */
+#define MADS_UNI_HASH_SEEDS 4
+
+
 /**
  * @brief Data structure that represents a universal hash function.
  */
@@ -29,6 +36,7 @@ typedef struct
     unsigned long long int kvalue; ///< @brief The key value used in the hash function.
     unsigned long long int *values; ///< @brief Pointer to the array of values generated by the hash function.
     unsigned long long int tabsize; ///< @brief The size of the table used by the hash function.
+    unsigned long long int seeds[MADS_UNI_HASH_SEEDS]; ///< @brief Random 64-bit seeds for the hash functions of mads/algorithms/hash.h.
 } mads_uni_hash_t;
 
 
@@ -40,6 +48,15 @@ typedef struct
  */
 MADS_EXPORT mads_uni_hash_t *mads_uni_hash_create(unsigned long long int ts, unsigned long long int k);
 
+/**
+ * @brief This function is used to create a new mads_uni_hash_t object for power of two table sizes.
+ * The generated values are random odd 64-bit numbers, so no primality search is performed.
+ * @param [in] ts - The size of the table used by the hash function, a power of two.
+ * @param [in] k - The key value used in the hash function.
+ * @return This function returns a pointer to the new mads_uni_hash_t object.
+ */
+MADS_EXPORT mads_uni_hash_t *mads_uni_hash_create_pow2(unsigned long long int ts, unsigned long long int k);
+
 /**
  * @brief This function is used to get the array of values generated by the hash function.
  * @param [in] h - A pointer to the mads_uni_hash_t object.
@@ -0,0 +1,177 @@
+// ReSharper disable CppDFANullDereference
+
+
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+#include <mads/algorithms/hash.h>
+
+
+// Multiplies two 64-bit numbers into a 128-bit product, stored back as its low and high halves
+static void hash_mum(unsigned long long int *a, unsigned long long int *b)
+{
+#if defined(__SIZEOF_INT128__)
+    const __uint128_t r = (__uint128_t)(*a) * (*b);
+    *a = (unsigned long long int)r;
+    *b = (unsigned long long int)(r >> 64);
+#elif defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+    *a = _umul128(*a, *b, b);
+#else
+    // Schoolbook multiplication over 32-bit halves
+    const unsigned long long int ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    const unsigned long long int rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    const unsigned long long int t = rl + (rm0 << 32);
+    unsigned long long int c = t < rl;
+    const unsigned long long int lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+// Multiplies two 64-bit numbers and folds the 128-bit product back into 64 bits
+static unsigned long long int hash_mix(unsigned long long int a, unsigned long long int b)
+{
+    hash_mum(&a, &b);
+    return a ^ b;
+}
+
+// Reads eight bytes as a native endian 64-bit number
+static unsigned long long int hash_read8(const unsigned char *p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// Reads four bytes as a native endian 32-bit number
+static unsigned long long int hash_read4(const unsigned char *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// Reads one to three bytes, touching the first, middle and last of them
+static unsigned long long int hash_read3(const unsigned char *p, const unsigned long long int k)
+{
+    return ((unsigned long long int)p[0] << 16) | ((unsigned long long int)p[k >> 1] << 8) | p[k - 1];
+}
+
+// Reduces a 64-bit hash to the table size of the universal hash
+static unsigned long long int hash_reduce(const mads_uni_hash_t *h, const unsigned long long int hval)
+{
+    const unsigned long long int tabsize = h->tabsize;
+    if ((tabsize & (tabsize - 1)) == 0) { return hval & (tabsize - 1); }
+    return hval % tabsize;
+}
+
+// Hashes the bytes into a full 64-bit value
+static unsigned long long int hash_bytes64(const unsigned long long int *s, const unsigned char *p, const unsigned long long int length)
+{
+    unsigned long long int a;
+    unsigned long long int b;
+    unsigned long long int seed = s[0] ^ hash_mix(s[0] ^ s[1], s[2]);
+
+    if (length <= 16)
+    {
+        if (length >= 4)
+        {
+            // Two overlapping reads of four bytes from each end cover up to sixteen bytes
+            const unsigned long long int offset = (length >> 3) << 2;
+            a = (hash_read4(p) << 32) | hash_read4(p + offset);
+            b = (hash_read4(p + length - 4) << 32) | hash_read4(p + length - 4 - offset);
+        }
+        else if (length > 0)
+        {
+            a = hash_read3(p, length);
+            b = 0;
+        }
+        else
+        {
+            a = 0;
+            b = 0;
+        }
+    }
+    else
+    {
+        unsigned long long int i = length;
+
+        if (i > 48)
+        {
+            // Three independent lanes per 48-byte block keep the multipliers busy
+            unsigned long long int see1 = seed;
+            unsigned long long int see2 = seed;
+
+            do
+            {
+                seed = hash_mix(hash_read8(p) ^ s[1], hash_read8(p + 8) ^ seed);
+                see1 = hash_mix(hash_read8(p + 16) ^ s[2], hash_read8(p + 24) ^ see1);
+                see2 = hash_mix(hash_read8(p + 32) ^ s[3], hash_read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            }
+            while (i > 48);
+
+            seed ^= see1 ^ see2;
+        }
+
+        while (i > 16)
+        {
+            seed = hash_mix(hash_read8(p) ^ s[1], hash_read8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+
+        // The last sixteen bytes, overlapping the previous block when needed
+        a = hash_read8(p + i - 16);
+        b = hash_read8(p + i - 8);
+    }
+
+    a ^= s[1];
+    b ^= seed;
+    hash_mum(&a, &b);
+    return hash_mix(a ^ s[0] ^ length, b ^ s[1]);
+}
+
+// Hashes a 64-bit number into a full 64-bit value
+static unsigned long long int hash_integer64(const unsigned long long int *s, const unsigned long long int x)
+{
+    unsigned long long int a = x ^ s[0];
+    unsigned long long int b = ((x << 32) | (x >> 32)) ^ s[1];
+    hash_mum(&a, &b);
+    return hash_mix(a ^ s[2], b ^ s[3]);
+}
+
+
+unsigned long long int mads_hash_bytes(const mads_uni_hash_t *h, const void *data, const unsigned long long int length)
+{
+    assert(h != NULL && (data != NULL || length == 0));
+    return hash_reduce(h, hash_bytes64(h->seeds, data, length));
+}
+
+
+unsigned long long int mads_hash_string(const mads_uni_hash_t *h, const void *data)
+{
+    assert(data != NULL);
+    return mads_hash_bytes(h, data, strlen(data));
+}
+
+
+unsigned long long int mads_hash_integer(const mads_uni_hash_t *h, const void *data)
+{
+    assert(h != NULL);
+    return hash_reduce(h, hash_integer64(h->seeds, (unsigned long long int)(uintptr_t)data));
+}
+
+
+unsigned long long int mads_hash_pointer(const mads_uni_hash_t *h, const void *data)
+{
+    assert(h != NULL);
+    return hash_reduce(h, hash_integer64(h->seeds, (unsigned long long int)(uintptr_t)data));
+}
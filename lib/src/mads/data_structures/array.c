@@ -5,16 +5,104 @@
 // Including the necessary libraries.
 // Stdio.h is included for input/output operations.
 // Stdlib.h is included for dynamic memory allocation.
+// String.h is included for memcpy() and memmove(), which move whole runs of blocks at once.
 // Assert.h is included to provide a macro called assert() which can be used to verify assumptions made by the program
 // and print a diagnostic message if this assumption is false.
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
 // Including the header file for mads_array_t.
 #include <mads/data_structures/array.h>
 
+
+// Static function that maps the index of an element to its position in the blocks. The index
+// may reach the size, so the position wraps around at most once.
+static size_t array_position(const mads_array_t *array, const size_t index)
+{
+    const size_t position = array->head + index;
+    return (position >= array->memsize ? position - array->memsize : position);
+}
+
+// Static function that moves the blocks to a new allocation of the given size, with the first
+// element at position zero.
+static void array_relayout(mads_array_t *array, const size_t memsize)
+{
+    assert(memsize >= array->size && memsize > 0);
+
+    // Blocks that already start with the first element keep their layout, so realloc may resize them in place.
+    if (array->head == 0)
+    {
+        void **resized_mblocks = (void **)realloc(array->mblocks, memsize * sizeof(void *));
+        assert(resized_mblocks != NULL);
+        array->mblocks = resized_mblocks;
+        array->memsize = memsize;
+        return;
+    }
+
+    void **new_mblocks = (void **)malloc(memsize * sizeof(void *));
+    assert(new_mblocks != NULL);
+
+    // The elements are copied in at most two runs: up to the end of the blocks, then from the start.
+    const size_t first_run = (array->size < array->memsize - array->head ? array->size : array->memsize - array->head);
+    if (first_run > 0) { memcpy(new_mblocks, &array->mblocks[array->head], first_run * sizeof(void *)); }
+    if (array->size > first_run) { memcpy(&new_mblocks[first_run], array->mblocks, (array->size - first_run) * sizeof(void *)); }
+
+    free(array->mblocks);
+    array->mblocks = new_mblocks;
+    array->memsize = memsize;
+    array->head = 0;
+}
+
+// Static function that moves count elements from the index src to the index dst, where the
+// indices are relative to the head. The runs are cut where either side wraps around, and are
+// visited in the direction that never overwrites an element before it is moved.
+static void array_move(const mads_array_t *array, size_t dst, size_t src, size_t count)
+{
+    if (dst < src)
+    {
+        while (count > 0)
+        {
+            const size_t from = array_position(array, src);
+            const size_t to = array_position(array, dst);
+            size_t run = count;
+            if (array->memsize - from < run) { run = array->memsize - from; }
+            if (array->memsize - to < run) { run = array->memsize - to; }
+
+            memmove(&array->mblocks[to], &array->mblocks[from], run * sizeof(void *));
+            src = src + run;
+            dst = dst + run;
+            count = count - run;
+        }
+
+        return;
+    }
+
+    while (count > 0)
+    {
+        // The runs end just past the last element still to move, on both sides.
+        const size_t from_end = array_position(array, src + count - 1) + 1;
+        const size_t to_end = array_position(array, dst + count - 1) + 1;
+        size_t run = count;
+        if (from_end < run) { run = from_end; }
+        if (to_end < run) { run = to_end; }
+
+        memmove(&array->mblocks[to_end - run], &array->mblocks[from_end - run], run * sizeof(void *));
+        count = count - run;
+    }
+}
+
+// Static function that copies count data into the blocks from the index on, in at most two runs.
+static void array_copy_in(const mads_array_t *array, const size_t index, void *const *data, const size_t count)
+{
+    const size_t position = array_position(array, index);
+    const size_t first_run = (count < array->memsize - position ? count : array->memsize - position);
+    if (first_run > 0) { memcpy(&array->mblocks[position], data, first_run * sizeof(void *)); }
+    if (count > first_run) { memcpy(array->mblocks, &data[first_run], (count - first_run) * sizeof(void *)); }
+}
+
 // The function for creating a new mads array. It takes three function pointers as parameters.
 // Comparator function is used to compare 2 data elements. It should return 0 if both elements are equal,
 // negative number if element-1 is smaller and positive number if element-1 is larger.
@@ -42,6 +130,9 @@ mads_array_t *mads_array_create(const mads_array_comparator_fn comparator, const
     // Set the array size as the initial size.
     new_array->memsize = initial_msize;
 
+    // The first element starts at the beginning of the blocks.
+    new_array->head = 0;
+
     // Set the initial index for the array as 0 (empty).
     new_array->size = 0;
 
@@ -55,16 +146,40 @@ mads_array_t *mads_array_create(const mads_array_comparator_fn comparator, const
 }
 
 // Function to return the memory blocks of the array.
-void **mads_array_data(const mads_array_t *array)
+void **mads_array_data(mads_array_t *array)
 {
     // Check if the array is not NULL. If it is, throw an assertion error.
     assert(array != NULL);
 
-    // Return the memory blocks of the array.
-    return array->mblocks;
+    // If the elements wrap around the end of the blocks, lay them out contiguously first.
+    if (array->size > array->memsize - array->head) { array_relayout(array, array->memsize); }
+
+    // Return the memory blocks of the array, starting with the first element.
+    return &array->mblocks[array->head];
 }
 
 
+// The function that makes room for at least the given number of elements in the array.
+void mads_array_reserve(mads_array_t *array, const size_t capacity)
+{
+    // Check if the array is not NULL. If it is, throw an assertion error.
+    assert(array != NULL);
+
+    // Grow the blocks only if they are too small, in a single step.
+    if (capacity > array->memsize) { array_relayout(array, capacity); }
+}
+
+// The function that releases the memory the array holds beyond its elements.
+void mads_array_shrink_to_fit(mads_array_t *array)
+{
+    // Check if the array is not NULL. If it is, throw an assertion error.
+    assert(array != NULL);
+
+    // Keep room for one element, so the blocks can still double when the array grows again.
+    const size_t fitted_msize = (array->size > 0 ? array->size : 1);
+    if (fitted_msize < array->memsize) { array_relayout(array, fitted_msize); }
+}
+
 // The function that appends data to the array.
 void mads_array_append(mads_array_t *array, void *data)
 {
@@ -95,24 +210,72 @@ void mads_array_insert_at(mads_array_t *array, const size_t index, void *data)
     assert(index >= 0 && index <= array->size);
 
     // Check if the array has reached its maximum capacity. If it has, double the size.
-    if (array->size == array->memsize)
+    if (array->size == array->memsize) { array_relayout(array, 2 * array->memsize); }
+
+    if (index < array->size / 2)
     {
-        const size_t double_msize = 2 * array->memsize;
-        array->mblocks = (void **)realloc(array->mblocks, double_msize * sizeof(void *)); // NOLINT(*-suspicious-realloc-usage)
-        assert(array->mblocks != NULL);
-        array->memsize = double_msize;
+        // The index is closer to the front: move the head one place back and shift the elements
+        // to the left of the index one place to the left. Prepending shifts nothing.
+        array->head = (array->head == 0 ? array->memsize - 1 : array->head - 1);
+        array_move(array, 0, 1, index);
+    }
+    else
+    {
+        // Shift all elements to the right of the index one place to the right. Appending shifts nothing.
+        array_move(array, index + 1, index, array->size - index);
     }
-
-    // Shift all elements to the right of the index one place to the right.
-    for (size_t i = array->size; i > index; i--) { array->mblocks[i] = array->mblocks[i - 1]; }
 
     // Insert the new element at the correct position.
-    array->mblocks[index] = data;
+    array->mblocks[array_position(array, index)] = data;
 
     // current size increase for the new element.
     array->size++;
 }
 
+// The function that inserts several data at a specific location in the array.
+void mads_array_insert_range(mads_array_t *array, const size_t index, void *const *data, const size_t count)
+{
+    // Check if the array is not NULL. If it is, throw an assertion error.
+    assert(array != NULL);
+
+    // Check if the index is within the correct range, and that the buffer exists if it is not empty.
+    assert(index <= array->size && (data != NULL || count == 0));
+
+    // If the new data do not fit, grow the blocks once, at least doubling them.
+    if (array->size + count > array->memsize)
+    {
+        const size_t double_msize = 2 * array->memsize;
+        array_relayout(array, (array->size + count > double_msize ? array->size + count : double_msize));
+    }
+
+    if (index < array->size - index)
+    {
+        // The index is closer to the front: move the head count places back and shift the
+        // elements to the left of the index count places to the left.
+        array->head = (array->head >= count ? array->head - count : array->head + array->memsize - count);
+        array_move(array, 0, count, index);
+    }
+    else
+    {
+        // Shift all elements to the right of the index count places to the right.
+        array_move(array, index + count, index, array->size - index);
+    }
+
+    // Copy the new data into the gap and account for them.
+    array_copy_in(array, index, data, count);
+    array->size = array->size + count;
+}
+
+// The function that appends several data to the array.
+void mads_array_append_n(mads_array_t *array, void *const *data, const size_t count)
+{
+    // Check if the array is not NULL. If it is, throw an assertion error.
+    assert(array != NULL);
+
+    // Insert the data at the end of the array.
+    mads_array_insert_range(array, array->size, data, count);
+}
+
 // The function that removes the data at a specific position in the array.
 void mads_array_remove_at(mads_array_t *array, const size_t index)
 {
@@ -125,17 +288,66 @@ void mads_array_remove_at(mads_array_t *array, const size_t index)
     // If the destructor function is available, call it.
     if (array->destructor != NULL)
     {
-        array->destructor(array->mblocks[index]);
-        array->mblocks[index] = NULL;
+        const size_t position = array_position(array, index);
+        array->destructor(array->mblocks[position]);
+        array->mblocks[position] = NULL;
     }
 
-    // Shift all elements to the right of the index one place to the left.
-    for (size_t i = index; i < array->size - 1; i++) { array->mblocks[i] = array->mblocks[i + 1]; }
+    if (index < array->size / 2)
+    {
+        // The index is closer to the front: shift the elements to the left of the index one place
+        // to the right and move the head after them. Removing the first element shifts nothing.
+        array_move(array, 1, 0, index);
+        array->head = (array->head == array->memsize - 1 ? 0 : array->head + 1);
+    }
+    else
+    {
+        // Shift all elements to the right of the index one place to the left.
+        array_move(array, index, index + 1, array->size - index - 1);
+    }
 
     // Index decrease after the deletion.
     array->size--;
 }
 
+// The function that removes several consecutive data from the array.
+void mads_array_remove_range(mads_array_t *array, const size_t index, const size_t count)
+{
+    // Check if the array is not NULL. If it is, throw an assertion error.
+    assert(array != NULL);
+
+    // Check if the range is within the array. If it is not, throw an assertion error.
+    assert(index <= array->size && count <= array->size - index);
+
+    // If the destructor function is available, call it on every removed element.
+    if (array->destructor != NULL)
+    {
+        for (size_t i = index; i < index + count; i++)
+        {
+            const size_t position = array_position(array, i);
+            array->destructor(array->mblocks[position]);
+            array->mblocks[position] = NULL;
+        }
+    }
+
+    if (index < array->size - index - count)
+    {
+        // The range is closer to the front: shift the elements to the left of it count places
+        // to the right and move the head after them.
+        array_move(array, count, 0, index);
+        array->head = array_position(array, count);
+    }
+    else
+    {
+        // Shift all elements to the right of the range count places to the left.
+        array_move(array, index, index + count, array->size - index - count);
+    }
+
+    // Size decrease after the deletion, with the first element back at the beginning of empty blocks.
+    array->size = array->size - count;
+    if (array->size == 0) { array->head = 0; }
+}
+
 // The function that updates the data at a specific position in the array.
 void mads_array_set_at(const mads_array_t *array, const size_t index, void *data)
 {
@@ -146,10 +358,11 @@ void mads_array_set_at(const mads_array_t *array, const size_t index, void *data
     assert(index >= 0 && index < array->size);
 
     // If the destructor function is available, free the old data
-    if (array->destructor != NULL) { array->destructor(array->mblocks[index]); }
+    const size_t position = array_position(array, index);
+    if (array->destructor != NULL) { array->destructor(array->mblocks[position]); }
 
     // Set the new data at the correct position.
-    array->mblocks[index] = data;
+    array->mblocks[position] = data;
 }
 
 // The function that retrieves data from a specific position in the array.
@@ -162,7 +375,7 @@ void *mads_array_get_at(const mads_array_t *array, const size_t index)
     assert(index >= 0 && index < array->size);
 
     // Return the data at the requested index.
-    return array->mblocks[index];
+    return array->mblocks[array_position(array, index)];
 }
 
 // The function that searches for an item in the array and returns the index it was found at. If not found, it returns -1.
@@ -174,7 +387,7 @@ int mads_array_has_element(const mads_array_t *array, const void *item)
     // Iterate over the array and use the comparator function to check if the item is in the array.
     for (size_t i = 0; i < array->size; i++)
     {
-        const int result = array->comparator(array->mblocks[i], item);
+        const int result = array->comparator(array->mblocks[array_position(array, i)], item);
         if (result == 0) { return i; }
     }
 
@@ -213,13 +426,15 @@ void mads_array_clear(mads_array_t *array)
     {
         for (size_t i = 0; i < array->size; i++)
         {
-            array->destructor(array->mblocks[i]);
-            array->mblocks[i] = NULL;
+            const size_t position = array_position(array, i);
+            array->destructor(array->mblocks[position]);
+            array->mblocks[position] = NULL;
         }
     }
 
-    // Set the array's index to zero (empty).
+    // Set the array's index to zero (empty), with the first element back at the beginning of the blocks.
     array->size = 0;
+    array->head = 0;
 }
 
 // The function that prints all items in the array.
@@ -239,7 +454,7 @@ void mads_array_print(const mads_array_t *array)
     printf("[ ");
     for (size_t i = 0; i < array->size; i++)
     {
-        array->printer(array->mblocks[i]);
+        array->printer(array->mblocks[array_position(array, i)]);
         printf(", ");
     }
     printf("\b\b ]\n");
@@ -256,8 +471,9 @@ void mads_array_free(mads_array_t **array)
     {
         for (size_t i = 0; i < (*array)->size; i++)
         {
-            (*array)->destructor((*array)->mblocks[i]);
-            (*array)->mblocks[i] = NULL;
+            const size_t position = array_position(*array, i);
+            (*array)->destructor((*array)->mblocks[position]);
+            (*array)->mblocks[position] = NULL;
         }
     }
 
@@ -0,0 +1,376 @@
+// ReSharper disable CppDFANullDereference
+
+
+// Including the necessary libraries.
+// Stdio.h is included for input/output operations.
+// Stdlib.h is included for dynamic memory allocation.
+// Assert.h is included to provide a macro called assert() which can be used to verify assumptions made by the program
+// and print a diagnostic message if this assumption is false.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <assert.h>
+
+// Including the header file for the atomic map.
+#include <mads/data_structures/atomic_map.h>
+
+
+// Static function that compares the key of a stored pair with the given key.
+static int atomic_map_compare_key(const mads_pair_t *p, const void *key)
+{
+    const mads_cue_t *cue = p->k;
+    return cue->comparator(cue->cue, key);
+}
+
+// Static function that frees a node together with the pair it holds.
+static void atomic_map_free_node(mads_atomic_map_node_t *node)
+{
+    mads_pair_free(&node->pair);
+    free(node);
+}
+
+// The reader stripe of the calling thread, assigned round robin on its first read.
+static atomic_uint atomic_map_next_stripe;
+static _Thread_local unsigned int atomic_map_stripe = UINT_MAX;
+
+// Static function that returns the reader counters of the calling thread.
+static mads_atomic_map_readers_t *atomic_map_readers(mads_atomic_map_t *m)
+{
+    if (atomic_map_stripe == UINT_MAX)
+    {
+        atomic_map_stripe = atomic_fetch_add(&atomic_map_next_stripe, 1) % MADS_ATOMIC_MAP_READER_STRIPES;
+    }
+
+    return &m->readers[atomic_map_stripe];
+}
+
+// Static function that counts the readers announced in the given epoch over all stripes.
+static unsigned long long int atomic_map_count_readers(mads_atomic_map_t *m, const unsigned long long int epoch)
+{
+    unsigned long long int count = 0;
+
+    for (int i = 0; i < MADS_ATOMIC_MAP_READER_STRIPES; i++)
+    {
+        count = count + atomic_load(&m->readers[i].count[epoch % 3]);
+    }
+
+    return count;
+}
+
+// Static function that announces a reader in the current epoch and returns that epoch.
+// The announcement only counts if the epoch did not move while it was made; otherwise a
+// writer may have already checked the counter, so the reader withdraws and tries again
+// in the new epoch. Epochs only advance when nodes are retired, so retries are rare.
+static unsigned long long int atomic_map_read_enter(mads_atomic_map_t *m)
+{
+    mads_atomic_map_readers_t *readers = atomic_map_readers(m);
+    unsigned long long int epoch = atomic_load(&m->epoch);
+
+    while (1)
+    {
+        atomic_fetch_add(&readers->count[epoch % 3], 1);
+        const unsigned long long int current = atomic_load(&m->epoch);
+        if (current == epoch) { return epoch; }
+        atomic_fetch_sub(&readers->count[epoch % 3], 1);
+        epoch = current;
+    }
+}
+
+// Static function that withdraws a reader announced in the given epoch.
+static void atomic_map_read_exit(mads_atomic_map_t *m, const unsigned long long int epoch)
+{
+    atomic_fetch_sub(&atomic_map_readers(m)->count[epoch % 3], 1);
+}
+
+// Static function that searches the bucket chain of the given key without taking a lock.
+// The caller must be announced as a reader for the returned node to stay valid.
+static mads_atomic_map_node_t *atomic_map_find(const mads_atomic_map_t *m, const void *key)
+{
+    const unsigned long long int position = m->hash(m->hfunc, key);
+    mads_atomic_map_node_t *node = atomic_load_explicit(&m->buckets[position], memory_order_acquire);
+
+    while (node != NULL && atomic_map_compare_key(node->pair, key) != 0)
+    {
+        node = atomic_load_explicit(&node->next, memory_order_acquire);
+    }
+
+    return node;
+}
+
+// Static function that searches the bucket chain of the given key while holding its writer
+// mutex. It returns the link pointing at the node holding the key, or NULL if the key is
+// not in the chain.
+static _Atomic(mads_atomic_map_node_t *) *atomic_map_find_link(const mads_atomic_map_t *m,
+    const unsigned long long int position,
+    const void *key)
+{
+    _Atomic(mads_atomic_map_node_t *) *link = &m->buckets[position];
+    mads_atomic_map_node_t *node = atomic_load_explicit(link, memory_order_relaxed);
+
+    while (node != NULL)
+    {
+        if (atomic_map_compare_key(node->pair, key) == 0) { return link; }
+        link = &node->next;
+        node = atomic_load_explicit(link, memory_order_relaxed);
+    }
+
+    return NULL;
+}
+
+// Static function that retires a node unlinked from its chain and frees the retired nodes
+// no reader can see anymore. A node retired in epoch e may still be seen by readers of
+// epochs up to e, so it is freed once the epoch reaches e + 2. The epoch advances from e
+// to e + 1 only when no reader of epoch e - 1 is left, which is the counter shared with
+// epoch e + 2 modulo three.
+static void atomic_map_retire(mads_atomic_map_t *m, mads_atomic_map_node_t *node)
+{
+    mads_atomic_map_node_t **link = NULL;
+    mtx_lock(&m->retire_mutex);
+
+    node->retire_epoch = atomic_load(&m->epoch);
+    node->retired_next = m->retired;
+    m->retired = node;
+
+    for (int i = 0; i < 2; i++)
+    {
+        const unsigned long long int epoch = atomic_load(&m->epoch);
+        if (atomic_map_count_readers(m, epoch + 2) != 0) { break; }
+        atomic_store(&m->epoch, epoch + 1);
+    }
+
+    const unsigned long long int epoch = atomic_load(&m->epoch);
+    link = &m->retired;
+
+    while (*link != NULL)
+    {
+        mads_atomic_map_node_t *retired_node = *link;
+
+        if (retired_node->retire_epoch + 2 <= epoch)
+        {
+            *link = retired_node->retired_next;
+            atomic_map_free_node(retired_node);
+        }
+        else
+        {
+            link = &retired_node->retired_next;
+        }
+    }
+
+    mtx_unlock(&m->retire_mutex);
+}
+
+// Static function that creates an unpublished node holding the given pair.
+static mads_atomic_map_node_t *atomic_map_create_node(mads_pair_t *p, mads_atomic_map_node_t *next)
+{
+    mads_atomic_map_node_t *node = (mads_atomic_map_node_t *)malloc(sizeof(mads_atomic_map_node_t));
+    assert(node != NULL);
+    node->pair = p;
+    atomic_init(&node->next, next);
+    node->retired_next = NULL;
+    node->retire_epoch = 0;
+    return node;
+}
+
+
+mads_atomic_map_t *mads_atomic_map_create(const mads_hash_table_hash_fn hash, const unsigned long long int size)
+{
+    mads_atomic_map_t *new_map = NULL;
+    assert(hash != NULL && size != 0);
+
+    new_map = (mads_atomic_map_t *)malloc(sizeof(*new_map));
+    assert(new_map != NULL);
+
+    new_map->buckets = malloc(size * sizeof(*new_map->buckets));
+    assert(new_map->buckets != NULL);
+
+    for (unsigned long long int i = 0; i < size; i++)
+    {
+        atomic_init(&new_map->buckets[i], NULL);
+    }
+
+    new_map->lock_count = (size < MADS_ATOMIC_MAP_LOCK_STRIPES ? size : MADS_ATOMIC_MAP_LOCK_STRIPES);
+    new_map->locks = (mtx_t *)malloc(new_map->lock_count * sizeof(mtx_t));
+    assert(new_map->locks != NULL);
+
+    for (unsigned long long int i = 0; i < new_map->lock_count; i++)
+    {
+        mtx_init(&new_map->locks[i], mtx_plain);
+    }
+
+    new_map->size = size;
+    atomic_init(&new_map->n, 0);
+    atomic_init(&new_map->epoch, 0);
+
+    for (int i = 0; i < MADS_ATOMIC_MAP_READER_STRIPES; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            atomic_init(&new_map->readers[i].count[j], 0);
+        }
+    }
+
+    mtx_init(&new_map->retire_mutex, mtx_plain);
+    new_map->retired = NULL;
+    new_map->hfunc = mads_uni_hash_create(size, 20);
+    new_map->hash = hash;
+    return new_map;
+}
+
+
+int mads_atomic_map_insert(mads_atomic_map_t *m, mads_pair_t *p)
+{
+    assert(m != NULL && p != NULL);
+    const void *key = mads_cue_get(mads_pair_get_cue(p));
+    const unsigned long long int position = m->hash(m->hfunc, key);
+    mtx_t *lock = &m->locks[position % m->lock_count];
+
+    mtx_lock(lock);
+
+    if (atomic_map_find_link(m, position, key) != NULL)
+    {
+        mtx_unlock(lock);
+        return 0;
+    }
+
+    // The node is fully built before the release store makes it visible to the readers.
+    mads_atomic_map_node_t *head = atomic_load_explicit(&m->buckets[position], memory_order_relaxed);
+    atomic_store_explicit(&m->buckets[position], atomic_map_create_node(p, head), memory_order_release);
+    atomic_fetch_add(&m->n, 1);
+    mtx_unlock(lock);
+    return 1;
+}
+
+
+void mads_atomic_map_replace(mads_atomic_map_t *m, mads_pair_t *p)
+{
+    assert(m != NULL && p != NULL);
+    mads_atomic_map_node_t *old_node = NULL;
+    const void *key = mads_cue_get(mads_pair_get_cue(p));
+    const unsigned long long int position = m->hash(m->hfunc, key);
+    mtx_t *lock = &m->locks[position % m->lock_count];
+
+    mtx_lock(lock);
+    _Atomic(mads_atomic_map_node_t *) *link = atomic_map_find_link(m, position, key);
+
+    if (link == NULL)
+    {
+        mads_atomic_map_node_t *head = atomic_load_explicit(&m->buckets[position], memory_order_relaxed);
+        atomic_store_explicit(&m->buckets[position], atomic_map_create_node(p, head), memory_order_release);
+        atomic_fetch_add(&m->n, 1);
+    }
+    else
+    {
+        // The new node takes the place of the old one, which readers may still be walking through.
+        old_node = atomic_load_explicit(link, memory_order_relaxed);
+        mads_atomic_map_node_t *next = atomic_load_explicit(&old_node->next, memory_order_relaxed);
+        atomic_store_explicit(link, atomic_map_create_node(p, next), memory_order_release);
+    }
+
+    mtx_unlock(lock);
+    if (old_node != NULL) { atomic_map_retire(m, old_node); }
+}
+
+
+int mads_atomic_map_lookup(mads_atomic_map_t *m, const void *key)
+{
+    assert(m != NULL);
+    const unsigned long long int epoch = atomic_map_read_enter(m);
+    const int found = (atomic_map_find(m, key) != NULL ? 1 : 0);
+    atomic_map_read_exit(m, epoch);
+    return found;
+}
+
+
+void *mads_atomic_map_get_value(mads_atomic_map_t *m, const void *key)
+{
+    void *value = NULL;
+    assert(m != NULL);
+    const unsigned long long int epoch = atomic_map_read_enter(m);
+    const mads_atomic_map_node_t *node = atomic_map_find(m, key);
+    if (node != NULL) { value = mads_value_get(mads_pair_get_value(node->pair)); }
+    atomic_map_read_exit(m, epoch);
+    return value;
+}
+
+
+void mads_atomic_map_remove(mads_atomic_map_t *m, const void *key)
+{
+    assert(m != NULL);
+    mads_atomic_map_node_t *node = NULL;
+    const unsigned long long int position = m->hash(m->hfunc, key);
+    mtx_t *lock = &m->locks[position % m->lock_count];
+
+    mtx_lock(lock);
+    _Atomic(mads_atomic_map_node_t *) *link = atomic_map_find_link(m, position, key);
+
+    if (link != NULL)
+    {
+        // Readers already past the link keep following the unlinked node to the rest of the chain.
+        node = atomic_load_explicit(link, memory_order_relaxed);
+        atomic_store_explicit(link, atomic_load_explicit(&node->next, memory_order_relaxed), memory_order_release);
+        atomic_fetch_sub(&m->n, 1);
+    }
+
+    mtx_unlock(lock);
+    if (node != NULL) { atomic_map_retire(m, node); }
+}
+
+
+void mads_atomic_map_print(const mads_atomic_map_t *m)
+{
+    assert(m != NULL);
+
+    for (unsigned long long int i = 0; i < m->size; i++)
+    {
+        printf("index %llu:[ ", i);
+
+        for (const mads_atomic_map_node_t *node = atomic_load(&m->buckets[i]); node != NULL; node = atomic_load(&node->next))
+        {
+            mads_pair_print(node->pair);
+            printf(" ");
+        }
+
+        printf("]\n");
+    }
+}
+
+
+void mads_atomic_map_free(mads_atomic_map_t **m)
+{
+    assert(m != NULL && *m != NULL);
+
+    for (unsigned long long int i = 0; i < (*m)->size; i++)
+    {
+        mads_atomic_map_node_t *node = atomic_load(&(*m)->buckets[i]);
+
+        while (node != NULL)
+        {
+            mads_atomic_map_node_t *next = atomic_load(&node->next);
+            atomic_map_free_node(node);
+            node = next;
+        }
+    }
+
+    while ((*m)->retired != NULL)
+    {
+        mads_atomic_map_node_t *next = (*m)->retired->retired_next;
+        atomic_map_free_node((*m)->retired);
+        (*m)->retired = next;
+    }
+
+    for (unsigned long long int i = 0; i < (*m)->lock_count; i++)
+    {
+        mtx_destroy(&(*m)->locks[i]);
+    }
+
+    mtx_destroy(&(*m)->retire_mutex);
+    free((*m)->locks);
+    (*m)->locks = NULL;
+    free((void *)(*m)->buckets);
+    (*m)->buckets = NULL;
+    mads_uni_hash_free(&(*m)->hfunc);
+    (*m)->hfunc = NULL;
+    free(*m);
+    *m = NULL;
+}
@@ -139,6 +139,52 @@ void mads_avl_tree_insert(mads_avl_tree_t *t, void *data)
 }
 
 
+static mads_avl_node_t *avl_tree_recursive_find_or_insert(mads_avl_node_t *node, const mads_avl_tree_comparator_fn cmp, void *data, void **found)
+{
+    mads_avl_node_t *new_node = NULL;
+    assert(cmp != NULL);
+
+    if (node == NULL)
+    {
+        new_node = (mads_avl_node_t *)malloc(sizeof(*new_node));
+        assert(new_node != NULL);
+        new_node->data = data;
+        new_node->left = NULL;
+        new_node->right = NULL;
+        new_node->height = 0;
+        *found = data;
+        return new_node;
+    }
+
+    const int compare = cmp(node->data, data);
+
+    if (compare > 0)
+    {
+        node->left = avl_tree_recursive_find_or_insert(node->left, cmp, data, found);
+    }
+    else if (compare < 0)
+    {
+        node->right = avl_tree_recursive_find_or_insert(node->right, cmp, data, found);
+    }
+    else
+    {
+        *found = node->data;
+        return node;
+    }
+
+    return avl_tree_balance(node);
+}
+
+
+void *mads_avl_tree_find_or_insert(mads_avl_tree_t *t, void *data)
+{
+    void *found = NULL;
+    assert(t != NULL);
+    t->root = avl_tree_recursive_find_or_insert(t->root, t->cmp, data, &found);
+    return found;
+}
+
+
 static mads_avl_node_t *avl_tree_recursive_search(mads_avl_node_t *node, const mads_avl_tree_comparator_fn cmp, void *item)
 {
     assert(cmp != NULL);
@@ -200,7 +246,7 @@ static mads_avl_node_t *avl_tree_find_min(mads_avl_node_t *node)
 }
 
 
-static mads_avl_node_t *avl_tree_recursive_remove(mads_avl_node_t *node, const mads_avl_tree_comparator_fn cmp, const mads_avl_tree_destructor_fn destroy, void *item)
+static mads_avl_node_t *avl_tree_recursive_remove(mads_avl_node_t *node, const mads_avl_tree_comparator_fn cmp, const mads_avl_tree_destructor_fn destroy, void *item, int *removed)
 {
     assert(cmp != NULL);
     if (node == NULL) { return node; }
@@ -208,14 +254,16 @@ static mads_avl_node_t *avl_tree_recursive_remove(mads_avl_node_t *node, const m
 
     if (compare > 0)
     {
-        node->left = avl_tree_recursive_remove(node->left, cmp, destroy, item);
+        node->left = avl_tree_recursive_remove(node->left, cmp, destroy, item, removed);
     }
     else if (compare < 0)
     {
-        node->right = avl_tree_recursive_remove(node->right, cmp, destroy, item);
+        node->right = avl_tree_recursive_remove(node->right, cmp, destroy, item, removed);
     }
     else
     {
+        if (node->right == NULL || node->left == NULL) { *removed = 1; }
+
         if (node->right == NULL && node->left == NULL)
         {
             if (destroy != NULL)
@@ -263,7 +311,7 @@ static mads_avl_node_t *avl_tree_recursive_remove(mads_avl_node_t *node, const m
             temp_data = node->data;
             node->data = min_node->data;
             min_node->data = temp_data;
-            node->right = avl_tree_recursive_remove(node->right, cmp, destroy, temp_data);
+            node->right = avl_tree_recursive_remove(node->right, cmp, destroy, temp_data, removed);
         }
     }
 
@@ -271,11 +319,13 @@ static mads_avl_node_t *avl_tree_recursive_remove(mads_avl_node_t *node, const m
 }
 
 
-void mads_avl_tree_remove(mads_avl_tree_t *t, void *item)
+int mads_avl_tree_remove(mads_avl_tree_t *t, void *item)
 {
+    int removed = 0;
     assert(t != NULL);
-    if (mads_avl_tree_is_empty(t)) { return; }
-    t->root = avl_tree_recursive_remove(t->root, t->cmp, t->destroy, item);
+    if (mads_avl_tree_is_empty(t)) { return removed; }
+    t->root = avl_tree_recursive_remove(t->root, t->cmp, t->destroy, item, &removed);
+    return removed;
 }
 
 
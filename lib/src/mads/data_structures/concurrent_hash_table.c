@@ -0,0 +1,222 @@
+// ReSharper disable CppDFANullDereference
+
+
+// Including the necessary libraries.
+// Stdio.h is included for input/output operations.
+// Stdlib.h is included for dynamic memory allocation.
+// Assert.h is included to provide a macro called assert() which can be used to verify assumptions made by the program
+// and print a diagnostic message if this assumption is false.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+// Including the header file for the concurrent hash table.
+#include <mads/data_structures/concurrent_hash_table.h>
+
+
+// Static function that holds the shard for reading. Readers wait while a writer holds the
+// shard or is waiting for it, so a steady stream of lookups cannot starve the updates.
+static void concurrent_hash_table_read_lock(mads_concurrent_hash_table_shard_t *shard)
+{
+    mtx_lock(&shard->mutex);
+
+    while (shard->writing == 1 || shard->waiting_writers > 0)
+    {
+        cnd_wait(&shard->condition, &shard->mutex);
+    }
+
+    shard->readers = shard->readers + 1;
+    mtx_unlock(&shard->mutex);
+}
+
+// Static function that releases the shard held for reading.
+static void concurrent_hash_table_read_unlock(mads_concurrent_hash_table_shard_t *shard)
+{
+    mtx_lock(&shard->mutex);
+    shard->readers = shard->readers - 1;
+    if (shard->readers == 0) { cnd_broadcast(&shard->condition); }
+    mtx_unlock(&shard->mutex);
+}
+
+// Static function that holds the shard for writing, once every reader has released it.
+static void concurrent_hash_table_write_lock(mads_concurrent_hash_table_shard_t *shard)
+{
+    mtx_lock(&shard->mutex);
+    shard->waiting_writers = shard->waiting_writers + 1;
+
+    while (shard->writing == 1 || shard->readers > 0)
+    {
+        cnd_wait(&shard->condition, &shard->mutex);
+    }
+
+    shard->waiting_writers = shard->waiting_writers - 1;
+    shard->writing = 1;
+    mtx_unlock(&shard->mutex);
+}
+
+// Static function that releases the shard held for writing.
+static void concurrent_hash_table_write_unlock(mads_concurrent_hash_table_shard_t *shard)
+{
+    mtx_lock(&shard->mutex);
+    shard->writing = 0;
+    cnd_broadcast(&shard->condition);
+    mtx_unlock(&shard->mutex);
+}
+
+// Static function that returns the shard responsible for the given key.
+static mads_concurrent_hash_table_shard_t *concurrent_hash_table_shard(const mads_concurrent_hash_table_t *t, const void *key)
+{
+    return &t->shards[t->hash(t->shard_hfunc, key)];
+}
+
+
+mads_concurrent_hash_table_t *mads_concurrent_hash_table_create(const mads_hash_table_hash_fn hash,
+    const int chain_type,
+    const unsigned long long int shard_count)
+{
+    return mads_concurrent_hash_table_create_with_options(hash, chain_type, shard_count, NULL);
+}
+
+
+mads_concurrent_hash_table_t *mads_concurrent_hash_table_create_with_options(const mads_hash_table_hash_fn hash,
+    const int chain_type,
+    const unsigned long long int shard_count,
+    const mads_hash_table_options_t *options)
+{
+    mads_concurrent_hash_table_t *new_table = NULL;
+    assert(hash != NULL && shard_count != 0);
+
+    new_table = (mads_concurrent_hash_table_t *)malloc(sizeof(*new_table));
+    assert(new_table != NULL);
+
+    new_table->shards = (mads_concurrent_hash_table_shard_t *)malloc(shard_count * sizeof(mads_concurrent_hash_table_shard_t));
+    assert(new_table->shards != NULL);
+
+    for (unsigned long long int i = 0; i < shard_count; i++)
+    {
+        mtx_init(&new_table->shards[i].mutex, mtx_plain);
+        cnd_init(&new_table->shards[i].condition);
+        new_table->shards[i].readers = 0;
+        new_table->shards[i].waiting_writers = 0;
+        new_table->shards[i].writing = 0;
+        new_table->shards[i].table = mads_hash_table_create_with_options(hash, chain_type, options);
+    }
+
+    new_table->shard_count = shard_count;
+    new_table->shard_hfunc = mads_uni_hash_create(shard_count, 20);
+    new_table->hash = hash;
+    return new_table;
+}
+
+
+int mads_concurrent_hash_table_insert(mads_concurrent_hash_table_t *t, mads_pair_t *p)
+{
+    int inserted = 0;
+    assert(t != NULL && p != NULL);
+    mads_concurrent_hash_table_shard_t *shard = concurrent_hash_table_shard(t, mads_cue_get(mads_pair_get_cue(p)));
+
+    concurrent_hash_table_write_lock(shard);
+    mads_hash_table_find_or_insert(shard->table, p, &inserted);
+    concurrent_hash_table_write_unlock(shard);
+    return inserted;
+}
+
+
+int mads_concurrent_hash_table_lookup(const mads_concurrent_hash_table_t *t, void *key)
+{
+    int found = 0;
+    assert(t != NULL);
+    mads_concurrent_hash_table_shard_t *shard = concurrent_hash_table_shard(t, key);
+
+    // Lookups never migrate buckets of an incremental resize, so readers can share the shard.
+    concurrent_hash_table_read_lock(shard);
+    found = mads_hash_table_lookup(shard->table, key);
+    concurrent_hash_table_read_unlock(shard);
+    return found;
+}
+
+
+void mads_concurrent_hash_table_remove(mads_concurrent_hash_table_t *t, void *key)
+{
+    assert(t != NULL);
+    mads_concurrent_hash_table_shard_t *shard = concurrent_hash_table_shard(t, key);
+
+    concurrent_hash_table_write_lock(shard);
+    mads_hash_table_remove(shard->table, key);
+    concurrent_hash_table_write_unlock(shard);
+}
+
+
+void *mads_concurrent_hash_table_get_value(const mads_concurrent_hash_table_t *t, void *key)
+{
+    void *value = NULL;
+    assert(t != NULL);
+    mads_concurrent_hash_table_shard_t *shard = concurrent_hash_table_shard(t, key);
+
+    concurrent_hash_table_read_lock(shard);
+    value = mads_hash_table_get_value(shard->table, key);
+    concurrent_hash_table_read_unlock(shard);
+    return value;
+}
+
+
+void mads_concurrent_hash_table_change_value(mads_concurrent_hash_table_t *t, void *key, void *value)
+{
+    assert(t != NULL);
+    mads_concurrent_hash_table_shard_t *shard = concurrent_hash_table_shard(t, key);
+
+    concurrent_hash_table_write_lock(shard);
+    mads_hash_table_change_value(shard->table, key, value);
+    concurrent_hash_table_write_unlock(shard);
+}
+
+
+unsigned long long int mads_concurrent_hash_table_size(const mads_concurrent_hash_table_t *t)
+{
+    unsigned long long int n = 0;
+    assert(t != NULL);
+
+    for (unsigned long long int i = 0; i < t->shard_count; i++)
+    {
+        concurrent_hash_table_read_lock(&t->shards[i]);
+        n = n + t->shards[i].table->n;
+        concurrent_hash_table_read_unlock(&t->shards[i]);
+    }
+
+    return n;
+}
+
+
+void mads_concurrent_hash_table_print(const mads_concurrent_hash_table_t *t)
+{
+    assert(t != NULL);
+
+    for (unsigned long long int i = 0; i < t->shard_count; i++)
+    {
+        printf("shard %llu:\n", i);
+        concurrent_hash_table_read_lock(&t->shards[i]);
+        mads_hash_table_print(t->shards[i].table);
+        concurrent_hash_table_read_unlock(&t->shards[i]);
+    }
+}
+
+
+void mads_concurrent_hash_table_free(mads_concurrent_hash_table_t **t)
+{
+    assert(t != NULL && *t != NULL);
+
+    for (unsigned long long int i = 0; i < (*t)->shard_count; i++)
+    {
+        mads_hash_table_free(&(*t)->shards[i].table);
+        cnd_destroy(&(*t)->shards[i].condition);
+        mtx_destroy(&(*t)->shards[i].mutex);
+    }
+
+    free((*t)->shards);
+    (*t)->shards = NULL;
+    mads_uni_hash_free(&(*t)->shard_hfunc);
+    (*t)->shard_hfunc = NULL;
+    free(*t);
+    *t = NULL;
+}
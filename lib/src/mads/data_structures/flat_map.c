@@ -0,0 +1,338 @@
+// ReSharper disable CppDFANullDereference
+
+
+// Including the necessary libraries.
+// Stdio.h is included for input/output operations.
+// Stdlib.h is included for dynamic memory allocation.
+// String.h is included for memset() which resets the control bytes.
+// Assert.h is included to provide a macro called assert() which can be used to verify assumptions made by the program
+// and print a diagnostic message if this assumption is false.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+// SSE2 lets a whole group of control bytes be compared with a single instruction.
+// It is part of every x86-64 target; other targets use the scalar loops below.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MADS_FLAT_MAP_USE_SSE2
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// Including the header file for the flat map.
+#include <mads/data_structures/flat_map.h>
+
+
+// Control byte values. A full slot stores the 7-bit fingerprint of its key, which is
+// never negative, so both markers can be recognised by their sign bit alone.
+#define FLAT_MAP_CTRL_EMPTY ((signed char)-128)
+#define FLAT_MAP_CTRL_DELETED ((signed char)-2)
+#define FLAT_MAP_FINGERPRINT_MASK ((1ULL << MADS_FLAT_MAP_FINGERPRINT_BITS) - 1)
+
+
+// Static function that returns a bit mask with bit i set when the i-th control byte of
+// the group equals the given byte.
+static unsigned int flat_map_group_match(const signed char *group, const signed char byte)
+{
+#ifdef MADS_FLAT_MAP_USE_SSE2
+    const __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+    return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(byte), ctrl));
+#else
+    unsigned int mask = 0;
+    for (unsigned int i = 0; i < MADS_FLAT_MAP_GROUP_WIDTH; i++)
+    {
+        mask |= (unsigned int)(group[i] == byte) << i;
+    }
+    return mask;
+#endif
+}
+
+// Static function that returns a bit mask with bit i set when the i-th slot of the
+// group is empty or deleted, i.e. when its control byte has the sign bit set.
+static unsigned int flat_map_group_match_free(const signed char *group)
+{
+#ifdef MADS_FLAT_MAP_USE_SSE2
+    return (unsigned int)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)group));
+#else
+    unsigned int mask = 0;
+    for (unsigned int i = 0; i < MADS_FLAT_MAP_GROUP_WIDTH; i++)
+    {
+        mask |= (unsigned int)(group[i] < 0) << i;
+    }
+    return mask;
+#endif
+}
+
+// Static function that returns the index of the lowest set bit of a non-zero mask.
+static unsigned int flat_map_lowest_bit(const unsigned int mask)
+{
+    assert(mask != 0);
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned int)__builtin_ctz(mask);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (unsigned int)index;
+#else
+    unsigned int index = 0;
+    while (((mask >> index) & 1U) == 0) { index++; }
+    return index;
+#endif
+}
+
+
+// Static function that computes the hashed index of a key. The universal hashing
+// function covers capacity * 2^7 values, so the high part selects the home slot and
+// the low 7 bits become the fingerprint stored in the control byte.
+static unsigned long long int flat_map_hash(const mads_flat_map_t *m, const void *key)
+{
+    const unsigned long long int hash = m->hash(m->hfunc, key);
+    assert(hash < (m->capacity << MADS_FLAT_MAP_FINGERPRINT_BITS));
+    return hash;
+}
+
+// Static function that searches for the given key. Groups are probed with a
+// triangular sequence, which visits every group once when their number is a power
+// of two. It returns the slot index of the key or the capacity if it was not found.
+static unsigned long long int flat_map_find(const mads_flat_map_t *m, const void *key, const unsigned long long int hash)
+{
+    const signed char fingerprint = (signed char)(hash & FLAT_MAP_FINGERPRINT_MASK);
+    const unsigned long long int groups = m->capacity / MADS_FLAT_MAP_GROUP_WIDTH;
+    unsigned long long int group = (hash >> MADS_FLAT_MAP_FINGERPRINT_BITS) / MADS_FLAT_MAP_GROUP_WIDTH;
+
+    for (unsigned long long int step = 1; step <= groups; step++)
+    {
+        const unsigned long long int base = group * MADS_FLAT_MAP_GROUP_WIDTH;
+        unsigned int matches = flat_map_group_match(m->ctrl + base, fingerprint);
+
+        // Only fingerprint hits reach the user-defined comparator.
+        while (matches != 0)
+        {
+            const unsigned long long int position = base + flat_map_lowest_bit(matches);
+            if (mads_cue_compare_to(mads_pair_get_cue(m->slots[position]), key) == 0) { return position; }
+            matches &= matches - 1;
+        }
+
+        // An empty slot in the group means the key was never pushed past it.
+        if (flat_map_group_match(m->ctrl + base, FLAT_MAP_CTRL_EMPTY) != 0) { break; }
+        group = (group + step) & (groups - 1);
+    }
+
+    return m->capacity;
+}
+
+// Static function that finds the first empty or deleted slot on the probe sequence of
+// the given hashed index. The caller guarantees that the map is never completely full.
+static unsigned long long int flat_map_find_free(const signed char *ctrl,
+    const unsigned long long int capacity,
+    const unsigned long long int hash)
+{
+    const unsigned long long int groups = capacity / MADS_FLAT_MAP_GROUP_WIDTH;
+    unsigned long long int group = (hash >> MADS_FLAT_MAP_FINGERPRINT_BITS) / MADS_FLAT_MAP_GROUP_WIDTH;
+
+    for (unsigned long long int step = 1;; step++)
+    {
+        const unsigned long long int base = group * MADS_FLAT_MAP_GROUP_WIDTH;
+        const unsigned int free_slots = flat_map_group_match_free(ctrl + base);
+        if (free_slots != 0) { return base + flat_map_lowest_bit(free_slots); }
+        group = (group + step) & (groups - 1);
+    }
+}
+
+// Static function that moves every pair into freshly allocated arrays of the given
+// capacity. The universal hashing function is recreated for the new capacity, which
+// also drops all deleted markers.
+static void flat_map_rehash(mads_flat_map_t *m, const unsigned long long int new_capacity)
+{
+    signed char *new_ctrl = NULL;
+    mads_pair_t **new_slots = NULL;
+    mads_uni_hash_t *new_h = NULL;
+
+    new_ctrl = (signed char *)malloc(new_capacity * sizeof(signed char));
+    assert(new_ctrl != NULL);
+    memset(new_ctrl, FLAT_MAP_CTRL_EMPTY, new_capacity * sizeof(signed char));
+    new_slots = (mads_pair_t **)malloc(new_capacity * sizeof(mads_pair_t *));
+    assert(new_slots != NULL);
+    new_h = mads_uni_hash_create_pow2(new_capacity << MADS_FLAT_MAP_FINGERPRINT_BITS, 20);
+
+    for (unsigned long long int i = 0; i < m->capacity; i++)
+    {
+        if (m->ctrl[i] < 0) { continue; }
+        const void *cue_data = mads_cue_get(mads_pair_get_cue(m->slots[i]));
+        const unsigned long long int hash = m->hash(new_h, cue_data);
+        const unsigned long long int position = flat_map_find_free(new_ctrl, new_capacity, hash);
+        new_ctrl[position] = (signed char)(hash & FLAT_MAP_FINGERPRINT_MASK);
+        new_slots[position] = m->slots[i];
+    }
+
+    mads_uni_hash_free(&m->hfunc);
+    m->hfunc = new_h;
+    free(m->ctrl);
+    m->ctrl = new_ctrl;
+    free(m->slots);
+    m->slots = new_slots;
+    m->capacity = new_capacity;
+    m->deleted = 0;
+}
+
+
+mads_flat_map_t *mads_flat_map_create(const mads_hash_table_hash_fn hash)
+{
+    mads_flat_map_t *new_map = NULL;
+    assert(hash != NULL);
+
+    new_map = (mads_flat_map_t *)malloc(sizeof(*new_map));
+    assert(new_map != NULL);
+
+    new_map->ctrl = (signed char *)malloc(MADS_FLAT_MAP_INITIAL_SIZE * sizeof(signed char));
+    assert(new_map->ctrl != NULL);
+    memset(new_map->ctrl, FLAT_MAP_CTRL_EMPTY, MADS_FLAT_MAP_INITIAL_SIZE * sizeof(signed char));
+
+    new_map->slots = (mads_pair_t **)malloc(MADS_FLAT_MAP_INITIAL_SIZE * sizeof(mads_pair_t *));
+    assert(new_map->slots != NULL);
+
+    new_map->n = 0;
+    new_map->deleted = 0;
+    new_map->capacity = MADS_FLAT_MAP_INITIAL_SIZE;
+    new_map->hfunc = mads_uni_hash_create_pow2(MADS_FLAT_MAP_INITIAL_SIZE << MADS_FLAT_MAP_FINGERPRINT_BITS, 20);
+    new_map->hash = hash;
+    return new_map;
+}
+
+
+void mads_flat_map_insert(mads_flat_map_t *m, mads_pair_t *p)
+{
+    assert(m != NULL && p != NULL);
+
+    // Keep at least one eighth of the slots empty so that probes terminate quickly.
+    // When most of the used slots are deleted markers, rehashing in place is enough.
+    if ((m->n + m->deleted + 1) * 8 > m->capacity * 7)
+    {
+        const unsigned long long int new_capacity = ((m->n + 1) * 16 > m->capacity * 7 ? m->capacity * 2 : m->capacity);
+        flat_map_rehash(m, new_capacity);
+    }
+
+    const void *cue_data = mads_cue_get(mads_pair_get_cue(p));
+    const unsigned long long int hash = flat_map_hash(m, cue_data);
+    if (flat_map_find(m, cue_data, hash) < m->capacity) { return; }
+
+    const unsigned long long int position = flat_map_find_free(m->ctrl, m->capacity, hash);
+    if (m->ctrl[position] == FLAT_MAP_CTRL_DELETED) { m->deleted = m->deleted - 1; }
+    m->ctrl[position] = (signed char)(hash & FLAT_MAP_FINGERPRINT_MASK);
+    m->slots[position] = p;
+    m->n = m->n + 1;
+}
+
+
+int mads_flat_map_lookup(const mads_flat_map_t *m, const void *key)
+{
+    assert(m != NULL);
+    return (flat_map_find(m, key, flat_map_hash(m, key)) < m->capacity ? 1 : 0);
+}
+
+
+void mads_flat_map_remove(mads_flat_map_t *m, const void *key)
+{
+    assert(m != NULL);
+    const unsigned long long int position = flat_map_find(m, key, flat_map_hash(m, key));
+    if (position == m->capacity) { return; }
+
+    mads_pair_free(&m->slots[position]);
+
+    // If the group still has an empty slot, no probe ever continued past it,
+    // so the slot can become empty again instead of leaving a deleted marker.
+    const unsigned long long int base = position - position % MADS_FLAT_MAP_GROUP_WIDTH;
+
+    if (flat_map_group_match(m->ctrl + base, FLAT_MAP_CTRL_EMPTY) != 0)
+    {
+        m->ctrl[position] = FLAT_MAP_CTRL_EMPTY;
+    }
+    else
+    {
+        m->ctrl[position] = FLAT_MAP_CTRL_DELETED;
+        m->deleted = m->deleted + 1;
+    }
+
+    m->n = m->n - 1;
+}
+
+
+void *mads_flat_map_get_value(const mads_flat_map_t *m, const void *key)
+{
+    assert(m != NULL);
+    const unsigned long long int position = flat_map_find(m, key, flat_map_hash(m, key));
+    if (position == m->capacity) { return NULL; }
+    return mads_value_get(mads_pair_get_value(m->slots[position]));
+}
+
+
+void mads_flat_map_change_value(const mads_flat_map_t *m, const void *key, void *value)
+{
+    assert(m != NULL);
+    const mads_value_t *old_value = NULL;
+    mads_value_t *new_value = NULL;
+    const unsigned long long int position = flat_map_find(m, key, flat_map_hash(m, key));
+    if (position == m->capacity) { return; }
+
+    old_value = mads_pair_get_value(m->slots[position]);
+    new_value = mads_value_create(value, old_value->comparator, old_value->printer, old_value->destructor);
+    mads_pair_change_value(m->slots[position], new_value);
+}
+
+
+void mads_flat_map_clear(mads_flat_map_t *m)
+{
+    assert(m != NULL);
+
+    for (unsigned long long int i = 0; i < m->capacity; i++)
+    {
+        if (m->ctrl[i] >= 0) { mads_pair_free(&m->slots[i]); }
+    }
+
+    memset(m->ctrl, FLAT_MAP_CTRL_EMPTY, m->capacity * sizeof(signed char));
+    m->n = 0;
+    m->deleted = 0;
+}
+
+
+void mads_flat_map_print(const mads_flat_map_t *m)
+{
+    assert(m != NULL);
+
+    if (m->n == 0)
+    {
+        printf("[]\n");
+        return;
+    }
+
+    printf("[ ");
+
+    for (unsigned long long int i = 0; i < m->capacity; i++)
+    {
+        if (m->ctrl[i] < 0) { continue; }
+        mads_pair_print(m->slots[i]);
+        printf(", ");
+    }
+
+    printf("\b\b ]\n");
+}
+
+
+void mads_flat_map_free(mads_flat_map_t **m)
+{
+    assert(m != NULL && *m != NULL);
+    mads_flat_map_clear(*m);
+    free((*m)->ctrl);
+    (*m)->ctrl = NULL;
+    free((*m)->slots);
+    (*m)->slots = NULL;
+    mads_uni_hash_free(&(*m)->hfunc);
+    (*m)->hfunc = NULL;
+    free(*m);
+    *m = NULL;
+}
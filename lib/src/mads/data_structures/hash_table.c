@@ -15,6 +15,32 @@
 #include <stdlib.h>
 #include <assert.h>
 
+// Software prefetching is used by the batch operations to overlap the memory accesses
+// of several keys. It degrades to nothing on compilers without a prefetch intrinsic.
+#if defined(__GNUC__) || defined(__clang__)
+#define HASH_TABLE_PREFETCH(address) __builtin_prefetch((address), 0, 3)
+#elif defined(_MSC_VER)
+#include <xmmintrin.h>
+#define HASH_TABLE_PREFETCH(address) _mm_prefetch((const char *)(address), _MM_HINT_T0)
+#else
+#define HASH_TABLE_PREFETCH(address) ((void)(address))
+#endif
+
+// Operation counters are compiled in only when the library is built with MADS_HASH_TABLE_STATS.
+// They are relaxed atomics, because the lookups of a shared table may run concurrently.
+#ifdef MADS_HASH_TABLE_STATS
+#include <time.h>
+#include <stdatomic.h>
+#define HASH_TABLE_COUNT(t, counter, amount) \
+    atomic_fetch_add_explicit(&(t)->counters->counter, (amount), memory_order_relaxed)
+#define HASH_TABLE_TIMER_START(start) const unsigned long long int start = hash_table_clock()
+#define HASH_TABLE_TIMER_STOP(t, start) HASH_TABLE_COUNT(t, rehash_nanoseconds, hash_table_clock() - (start))
+#else
+#define HASH_TABLE_COUNT(t, counter, amount) ((void)(t))
+#define HASH_TABLE_TIMER_START(start) ((void)0)
+#define HASH_TABLE_TIMER_STOP(t, start) ((void)(t))
+#endif
+
 // Including the header files for the doubly linked list,
 // the balanced binary tree and the hash table.
 #include <mads/data_structures/list.h>
@@ -22,18 +48,45 @@
 #include <mads/data_structures/hash_table.h>
 
 
+// The key length passed along with a whole key, as opposed to a byte slice of a given length.
+// A whole key is compared with the cue comparator, a slice with the compare_by option.
+#define HASH_TABLE_WHOLE_KEY (~0ULL)
+
+
+#ifdef MADS_HASH_TABLE_STATS
+// The live operation counters of a hash table.
+struct mads_hash_table_live_counters_t
+{
+    atomic_ullong lookups;
+    atomic_ullong hits;
+    atomic_ullong misses;
+    atomic_ullong comparisons;
+    atomic_ullong rehashes;
+    atomic_ullong rehash_nanoseconds;
+};
+
+// Static function that reads the clock used to time the resizes, in nanoseconds.
+static unsigned long long int hash_table_clock(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (unsigned long long int)ts.tv_sec * 1000000000ULL + (unsigned long long int)ts.tv_nsec;
+}
+#endif
+
+
 // Comparator function for the pair data structure of the hash table.
 static int hash_table_compare_pairs(const void *p1, const void *p2)
 {
     const mads_pair_t *pp1 = NULL;
     const mads_pair_t *pp2 = NULL;
     const mads_cue_t *c1 = NULL;
-    const mads_cue_t *c2 = NULL;
     pp1 = (mads_pair_t *)p1;
     pp2 = (mads_pair_t *)p2;
-    c1 = mads_pair_get_cue(pp1);
-    c2 = mads_pair_get_cue(pp2);
-    return mads_cue_compare_to(c1, mads_cue_get(c2));
+
+    // The cue comparator is called directly, this runs at every step of a tree bucket.
+    c1 = pp1->k;
+    return c1->comparator(c1->cue, pp2->k->cue);
 }
 
 
@@ -112,320 +165,1548 @@ static unsigned long long int hash_table_next_prime(const unsigned long long int
     return step;
 }
 
-
-static void hash_table_rehash(mads_hash_table_t *t)
+// Static function that computes the size of a bucket array able to hold at least the given
+// number of buckets under the sizing policy of the hash table: the next power of two, or
+// the next prime number.
+static unsigned long long int hash_table_fit_size(const mads_hash_table_t *t, const unsigned long long int n)
 {
-    assert(t != NULL);
-    mads_uni_hash_t *new_h = NULL;
-    const void *cue_data = NULL;
-    unsigned long long int i, position;
-    const mads_cue_t *temp_cue = NULL;
-    mads_pair_t *temp_pair = NULL;
-    mads_avl_tree_t *temp_tree = NULL;
-    mads_list_t *temp_list = NULL;
-    void **new_array = NULL;
-    void **old_array = NULL;
-    const unsigned long long int new_size = hash_table_next_prime((t->size) * 2);
-    new_array = (void **)malloc(new_size * sizeof(void *));
-    assert(new_array != NULL);
-    new_h = mads_uni_hash_create(new_size, 20);
+    unsigned long long int size = 1;
 
-    for (i = 0; i < new_size; i++)
+    if (t->options.sizing == MADS_HASH_TABLE_SIZING_POW2)
     {
-        if (t->chain_type == MADS_HASH_TABLE_CHAIN_LIST)
-        {
-            new_array[i] = mads_list_create(
-                hash_table_compare_pairs,
-                hash_table_print_pair,
-                hash_table_deallocate_pair);
-        }
-        else if (t->chain_type == MADS_HASH_TABLE_CHAIN_TREE)
-        {
-            new_array[i] = mads_avl_tree_create(
-                hash_table_compare_pairs,
-                hash_table_print_pair,
-                hash_table_deallocate_pair);
-        }
-        else {}
+        while (size < n) { size = size << 1; }
+        return size;
     }
 
-    for (i = 0; i < t->size; i++)
+    return (n < 2 ? 2 : hash_table_next_prime(n - 1));
+}
+
+// Static function that computes the hash code of the given key, or of the byte slice of the
+// given length. The hashing function hashes into a fixed wide range that does not depend on
+// the size of the bucket array, so the code is cached in the pair and never recomputed when
+// the table is resized. Power of two tables mix the code, so every bit of it affects the low
+// bits kept by the mask.
+static unsigned long long int hash_table_code(const mads_hash_table_t *t, const void *key, const unsigned long long int length)
+{
+    unsigned long long int hval = (length == HASH_TABLE_WHOLE_KEY ? t->hash(t->hfunc, key) : t->options.hash_by(t->hfunc, key, length));
+
+    if (t->options.sizing == MADS_HASH_TABLE_SIZING_POW2)
     {
-        if (t->chain_type == MADS_HASH_TABLE_CHAIN_LIST)
-        {
-            temp_list = t->A[i];
-            temp_list->destroy = NULL;
+        hval = hval ^ (hval >> 32);
+        hval = hval * 0x9E3779B97F4A7C15ULL;
+        hval = hval ^ (hval >> 29);
+    }
 
-            while (!mads_list_is_empty(temp_list))
-            {
-                temp_pair = mads_list_get_head(temp_list);
-                temp_cue = mads_pair_get_cue(temp_pair);
-                cue_data = mads_cue_get(temp_cue);
-                position = t->hash(new_h, cue_data);
-                mads_list_push(new_array[position], temp_pair);
-                mads_list_remove_head(temp_list);
-            }
+    return hval;
+}
 
-            mads_list_free(&temp_list);
-        }
-        else if (t->chain_type == MADS_HASH_TABLE_CHAIN_TREE)
-        {
-            temp_tree = t->A[i];
-            temp_tree->destroy = NULL;
+// Static function that reduces a hash code to an index of a bucket array of the given size,
+// with a mask for power of two tables and modulo the prime size otherwise.
+static unsigned long long int hash_table_reduce(const mads_hash_table_t *t,
+    const unsigned long long int code,
+    const unsigned long long int size)
+{
+    if (t->options.sizing == MADS_HASH_TABLE_SIZING_POW2) { return code & (size - 1); }
+    return code % size;
+}
 
-            while (!mads_avl_tree_is_empty(temp_tree))
-            {
-                temp_pair = mads_avl_tree_get_root(temp_tree);
-                temp_cue = mads_pair_get_cue(temp_pair);
-                cue_data = mads_cue_get(temp_cue);
-                position = t->hash(new_h, cue_data);
-                mads_avl_tree_insert(new_array[position], temp_pair);
-                mads_avl_tree_remove_root(temp_tree);
-            }
 
-            mads_avl_tree_free(temp_tree);
-        }
+// Static function that creates an empty bucket container for the chaining method of the table.
+static void *hash_table_create_bucket(const int chain_type)
+{
+    if (chain_type == MADS_HASH_TABLE_CHAIN_LIST)
+    {
+        return mads_list_create(
+            hash_table_compare_pairs,
+            hash_table_print_pair,
+            hash_table_deallocate_pair);
     }
+    else if (chain_type == MADS_HASH_TABLE_CHAIN_TREE)
+    {
+        return mads_avl_tree_create(
+            hash_table_compare_pairs,
+            hash_table_print_pair,
+            hash_table_deallocate_pair);
+    }
+    else
+    {
+        return NULL;
+    }
+}
 
-    mads_uni_hash_free((mads_uni_hash_t **)t->hfunc);
-    t->hfunc = new_h;
-    old_array = t->A;
-    free(old_array);
-    t->A = new_array;
-    t->size = new_size;
-    hash_table_load_factor(t);
+// Static function that returns the chaining method of the bucket at the given position of
+// a bucket array. Every bucket of a hybrid table is a list or a tree on its own, as told by
+// the tree flags of its bucket array.
+static int hash_table_bucket_type(const mads_hash_table_t *t, void *const *A, const unsigned long long int position)
+{
+    if (t->chain_type != MADS_HASH_TABLE_CHAIN_HYBRID) { return t->chain_type; }
+    const unsigned char *trees = (A == t->old_A ? t->old_trees : t->trees);
+    return (trees[position] != 0 ? MADS_HASH_TABLE_CHAIN_TREE : MADS_HASH_TABLE_CHAIN_LIST);
 }
 
+// Static function that sets the tree flag of the bucket at the given position of a bucket
+// array of a hybrid table.
+static void hash_table_set_bucket_type(const mads_hash_table_t *t,
+    void *const *A,
+    const unsigned long long int position,
+    const int chain_type)
+{
+    unsigned char *trees = (A == t->old_A ? t->old_trees : t->trees);
+    trees[position] = (chain_type == MADS_HASH_TABLE_CHAIN_TREE ? 1 : 0);
+}
 
-mads_hash_table_t *mads_hash_table_create(const mads_hash_table_hash_fn hash, const int chain_type)
+// Static function that returns the bucket at the given position of a bucket array,
+// creating it first if it has not been allocated yet.
+static void *hash_table_get_bucket(const mads_hash_table_t *t, void **A, const unsigned long long int position)
 {
-    mads_hash_table_t *new_table = NULL;
-    assert(hash != NULL);
-    assert(chain_type == MADS_HASH_TABLE_CHAIN_LIST || chain_type == MADS_HASH_TABLE_CHAIN_TREE);
+    if (A[position] == NULL) { A[position] = hash_table_create_bucket(hash_table_bucket_type(t, A, position)); }
+    return A[position];
+}
 
-    new_table = (mads_hash_table_t *)malloc(sizeof(*new_table));
-    assert(new_table != NULL);
+// Static function that frees a bucket container together with the pairs it holds.
+static void hash_table_free_bucket(const int chain_type, void *bucket)
+{
+    if (bucket == NULL) { return; }
+
+    if (chain_type == MADS_HASH_TABLE_CHAIN_LIST)
+    {
+        mads_list_t *list = bucket;
+        mads_list_free(&list);
+    }
+    else if (chain_type == MADS_HASH_TABLE_CHAIN_TREE)
+    {
+        mads_avl_tree_free(bucket);
+    }
+}
 
-    new_table->A = (void **)malloc(MADS_HASH_TABLE_INITIAL_SIZE * sizeof(void *));
-    assert(new_table->A != NULL);
+// Static function that empties a bucket container, freeing the pairs it holds but keeping
+// the container itself allocated for reuse.
+static void hash_table_empty_bucket(const int chain_type, void *bucket)
+{
+    if (bucket == NULL) { return; }
 
-    new_table->chain_type = chain_type;
+    if (chain_type == MADS_HASH_TABLE_CHAIN_LIST)
+    {
+        while (!mads_list_is_empty(bucket)) { mads_list_remove_head(bucket); }
+    }
+    else if (chain_type == MADS_HASH_TABLE_CHAIN_TREE)
+    {
+        while (!mads_avl_tree_is_empty(bucket)) { mads_avl_tree_remove_root(bucket); }
+    }
+}
+
+// Static function that converts the list bucket at the given position of a hybrid table
+// into a tree bucket holding the same pairs.
+static void hash_table_treeify(const mads_hash_table_t *t, void **A, const unsigned long long int position)
+{
+    mads_list_t *list = A[position];
+    mads_avl_tree_t *tree = hash_table_create_bucket(MADS_HASH_TABLE_CHAIN_TREE);
 
-    for (unsigned long long int i = 0; i < MADS_HASH_TABLE_INITIAL_SIZE; i++)
+    for (const mads_llnode_t *node = list->head; node != NULL; node = node->next)
     {
-        if (new_table->chain_type == MADS_HASH_TABLE_CHAIN_LIST)
-        {
-            new_table->A[i] = mads_list_create(
-                hash_table_compare_pairs,
-                hash_table_print_pair,
-                hash_table_deallocate_pair);
-        }
-        else if (new_table->chain_type == MADS_HASH_TABLE_CHAIN_TREE)
-        {
-            new_table->A[i] = mads_avl_tree_create(
-                hash_table_compare_pairs,
-                hash_table_print_pair,
-                hash_table_deallocate_pair);
-        }
+        mads_avl_tree_insert(tree, node->data);
     }
 
-    new_table->n = 0;
-    new_table->size = MADS_HASH_TABLE_INITIAL_SIZE;
-    new_table->load_factor = (double)(new_table->n) / (new_table->size);
-    new_table->hfunc = mads_uni_hash_create(MADS_HASH_TABLE_INITIAL_SIZE, 20);
-    new_table->hash = hash;
-    return new_table;
+    list->destroy = NULL;
+    mads_list_free(&list);
+    A[position] = tree;
+    hash_table_set_bucket_type(t, A, position, MADS_HASH_TABLE_CHAIN_TREE);
 }
 
-void mads_hash_table_insert(mads_hash_table_t *t, mads_pair_t *p)
+// Static function that converts the tree bucket at the given position of a hybrid table
+// back into a list bucket holding the same pairs.
+static void hash_table_untreeify(const mads_hash_table_t *t, void **A, const unsigned long long int position)
 {
-    const double load_factor = hash_table_load_factor(t);
-    if (load_factor > 0.85) { hash_table_rehash(t); }
-    const mads_cue_t *temp_cue = NULL;
-    void *cue_data = NULL;
-    assert(t != NULL && p != NULL);
-    temp_cue = mads_pair_get_cue(p);
-    cue_data = mads_cue_get(temp_cue);
-    if (mads_hash_table_lookup(t, cue_data) == 1) { return; }
-    const unsigned long long int position = t->hash(t->hfunc, cue_data);
+    mads_avl_tree_t *tree = A[position];
+    mads_list_t *list = hash_table_create_bucket(MADS_HASH_TABLE_CHAIN_LIST);
+    tree->destroy = NULL;
 
-    if (t->chain_type == MADS_HASH_TABLE_CHAIN_LIST)
+    while (!mads_avl_tree_is_empty(tree))
     {
-        mads_list_push(t->A[position], p);
-        t->n = t->n + 1;
+        mads_list_push(list, mads_avl_tree_get_root(tree));
+        mads_avl_tree_remove_root(tree);
     }
-    else if (t->chain_type == MADS_HASH_TABLE_CHAIN_TREE)
+
+    mads_avl_tree_free(tree);
+    A[position] = list;
+    hash_table_set_bucket_type(t, A, position, MADS_HASH_TABLE_CHAIN_LIST);
+}
+
+// Static function that adds a pair whose key is known to be missing to the bucket at the
+// given position, allocating the bucket if needed. A list bucket of a hybrid table that
+// grows past the threshold becomes a tree.
+static void hash_table_bucket_add(const mads_hash_table_t *t, void **A, const unsigned long long int position, mads_pair_t *p)
+{
+    void *bucket = hash_table_get_bucket(t, A, position);
+
+    if (hash_table_bucket_type(t, A, position) == MADS_HASH_TABLE_CHAIN_TREE)
     {
-        mads_avl_tree_insert(t->A[position], p);
-        t->n = t->n + 1;
+        mads_avl_tree_insert(bucket, p);
+        return;
     }
 
-    hash_table_load_factor(t);
-}
+    mads_list_push(bucket, p);
 
+    if (t->chain_type == MADS_HASH_TABLE_CHAIN_HYBRID && mads_list_size(bucket) > MADS_HASH_TABLE_TREEIFY_THRESHOLD)
+    {
+        hash_table_treeify(t, A, position);
+    }
+}
 
-int mads_hash_table_lookup(const mads_hash_table_t *t, void *key)
+// Static function that prints a bucket container. A bucket that has not been
+// allocated yet is printed as an empty one.
+static void hash_table_print_bucket(const int chain_type, const void *bucket)
 {
-    assert(t != NULL);
-    int chain_query;
-    mads_pair_t temp_pair;
-    mads_cue_t temp_cue;
-    const unsigned long long int position = t->hash(t->hfunc, key);
-    temp_cue.cue = key;
-    temp_pair.k = &temp_cue;
-
-    if (t->chain_type == MADS_HASH_TABLE_CHAIN_LIST)
+    if (bucket == NULL)
     {
-        chain_query = mads_list_has_elem(t->A[position], &temp_pair);
-        return (chain_query > -1 ? 1 : 0);
+        printf("[]\n");
+        return;
     }
-    else if (t->chain_type == MADS_HASH_TABLE_CHAIN_TREE)
+
+    if (chain_type == MADS_HASH_TABLE_CHAIN_LIST)
     {
-        chain_query = mads_avl_tree_search(t->A[position], &temp_pair);
-        return chain_query;
+        mads_list_print(bucket);
     }
-    else
+    else if (chain_type == MADS_HASH_TABLE_CHAIN_TREE)
     {
-        return 0;
+        mads_avl_tree_print(bucket);
     }
 }
 
+// Static function that computes how far the pair stored at the given position
+// has been displaced from its home slot, wrapping around the end of the slot array.
+static unsigned long long int hash_table_probe_distance(const unsigned long long int position,
+    const unsigned long long int home,
+    const unsigned long long int size)
+{
+    return (position >= home ? position - home : position + size - home);
+}
+
+// Static function that compares the key of a stored pair with the given key, or with the
+// byte slice of the given length. A single comparator is called directly, without building
+// a temporary pair around the key.
+static int hash_table_compare_key(const mads_hash_table_t *t,
+    const mads_pair_t *p,
+    const void *key,
+    const unsigned long long int length)
+{
+    HASH_TABLE_COUNT(t, comparisons, 1);
+    const mads_cue_t *cue = p->k;
+    if (length == HASH_TABLE_WHOLE_KEY) { return cue->comparator(cue->cue, key); }
+    return t->options.compare_by(cue->cue, key, length);
+}
 
-void mads_hash_table_remove(mads_hash_table_t *t, void *key)
+// Static function that checks whether a stored pair holds the given key. The cached hash
+// codes are compared first, so the comparator only runs for keys that are likely equal.
+static int hash_table_matches_key(const mads_hash_table_t *t,
+    const mads_pair_t *p,
+    const unsigned long long int code,
+    const void *key,
+    const unsigned long long int length)
 {
-    assert(t != NULL);
-    mads_pair_t temp_pair;
-    mads_cue_t temp_cue;
-    const unsigned long long int position = t->hash(t->hfunc, key);
-    if (mads_hash_table_lookup(t, key) == 0) { return; }
-    temp_cue.cue = key;
-    temp_pair.k = &temp_cue;
+    return (p->hash == code && hash_table_compare_key(t, p, key, length) == 0);
+}
 
-    if (t->chain_type == MADS_HASH_TABLE_CHAIN_LIST)
+// Static function that stores a slot at the given position of a Robin Hood slot array and
+// shifts the pairs from there up to the next free slot one slot onwards. The shifted pairs
+// keep their order, so the pairs of a multimap key stay in consecutive slots.
+static void hash_table_robin_hood_shift_in(mads_hash_table_slot_t *slots,
+    const unsigned long long int size,
+    mads_hash_table_slot_t incoming,
+    unsigned long long int position)
+{
+    while (slots[position].pair != NULL)
     {
-        const unsigned long long int chain_pos = mads_list_has_elem(t->A[position], &temp_pair);
-        mads_list_remove_at(t->A[position], chain_pos);
-        t->n = t->n - 1;
+        const mads_hash_table_slot_t temp_slot = slots[position];
+        slots[position] = incoming;
+        incoming = temp_slot;
+        position = (position + 1 == size ? 0 : position + 1);
     }
-    else if (t->chain_type == MADS_HASH_TABLE_CHAIN_TREE)
+
+    slots[position] = incoming;
+}
+
+// Static function that places a slot into a Robin Hood slot array, starting at the given
+// position where the incoming pair is already the given distance away from its home. The
+// pair goes before the first resident pair that is closer to its home than the incoming
+// pair would be, and the rest of the run moves one slot on. This keeps the slots ordered
+// by home and the variance of the probe lengths low. The caller guarantees a free slot exists.
+static void hash_table_robin_hood_place(mads_hash_table_slot_t *slots,
+    const unsigned long long int size,
+    const mads_hash_table_slot_t incoming,
+    unsigned long long int position,
+    unsigned long long int distance)
+{
+    while (slots[position].pair != NULL && hash_table_probe_distance(position, slots[position].hash, size) >= distance)
     {
-        mads_avl_tree_remove(t->A[position], &temp_pair);
-        t->n = t->n - 1;
+        position = (position + 1 == size ? 0 : position + 1);
+        distance++;
     }
 
-    hash_table_load_factor(t);
+    hash_table_robin_hood_shift_in(slots, size, incoming, position);
 }
 
-
-void *mads_hash_table_get_value(const mads_hash_table_t *t, void *key)
+// Static function that searches a Robin Hood slot array for the given key. The probe
+// stops at an empty slot or at a resident pair closer to its home than we are to ours,
+// because Robin Hood placement would have put the key before it. It returns the position
+// of the pair holding the key, or the size of the table if the key was not found.
+static unsigned long long int hash_table_robin_hood_find(const mads_hash_table_t *t,
+    const unsigned long long int hash,
+    const unsigned long long int code,
+    const void *key,
+    const unsigned long long int length)
 {
-    assert(t != NULL);
-    mads_cue_t temp_cue;
-    mads_pair_t temp_pair;
-    const mads_pair_t *returned_pair = NULL;
-    const mads_value_t *returned_value = NULL;
-    if (mads_hash_table_lookup(t, key) == 0) { return NULL; }
-    const unsigned long long int position = t->hash(t->hfunc, key);
-    temp_cue.cue = key;
-    temp_pair.k = &temp_cue;
+    unsigned long long int position = hash;
 
-    if (t->chain_type == MADS_HASH_TABLE_CHAIN_LIST)
+    for (unsigned long long int distance = 0; distance < t->size; distance++)
     {
-        const unsigned long long int chain_query = mads_list_has_elem(t->A[position], &temp_pair);
-        returned_pair = mads_list_get_at(t->A[position], chain_query);
-        returned_value = mads_pair_get_value(returned_pair);
-        return mads_value_get(returned_value);
+        const mads_hash_table_slot_t *slot = &t->slots[position];
+        if (slot->pair == NULL) { break; }
+        if (hash_table_probe_distance(position, slot->hash, t->size) < distance) { break; }
+        if (slot->hash == hash && hash_table_matches_key(t, slot->pair, code, key, length) == 1) { return position; }
+        position = (position + 1 == t->size ? 0 : position + 1);
     }
-    else if (t->chain_type == MADS_HASH_TABLE_CHAIN_TREE)
+
+    return t->size;
+}
+
+// Static function that searches a Robin Hood slot array for the key of the given pair
+// and places the pair at the point where the search proves the key is missing, so the
+// run is walked only once. It returns the pair stored for the key afterwards. A multimap
+// places the pair right after the pairs already holding its key instead, so they stay in
+// consecutive slots; the pairs of one key share their home, so the slots stay ordered by home.
+static mads_pair_t *hash_table_robin_hood_find_or_place(const mads_hash_table_t *t,
+    mads_pair_t *p,
+    const unsigned long long int hash,
+    const void *key)
+{
+    mads_hash_table_slot_t incoming;
+    unsigned long long int position = hash;
+    incoming.pair = p;
+    incoming.hash = hash;
+
+    for (unsigned long long int distance = 0;; distance++)
     {
-        returned_pair = mads_avl_tree_get_elem(t->A[position], &temp_pair);
-        returned_value = mads_pair_get_value(returned_pair);
-        return mads_value_get(returned_value);
+        const mads_hash_table_slot_t *slot = &t->slots[position];
+
+        if (slot->pair == NULL || hash_table_probe_distance(position, slot->hash, t->size) < distance)
+        {
+            hash_table_robin_hood_place(t->slots, t->size, incoming, position, distance);
+            return p;
+        }
+
+        if (slot->hash == hash && hash_table_matches_key(t, slot->pair, p->hash, key, HASH_TABLE_WHOLE_KEY) == 1)
+        {
+            if (t->options.multimap == 0) { return slot->pair; }
+            break;
+        }
+
+        position = (position + 1 == t->size ? 0 : position + 1);
     }
-    else
+
+    // Skip the run of the key, then take the slot after it.
+    do { position = (position + 1 == t->size ? 0 : position + 1); }
+    while (t->slots[position].pair != NULL
+        && t->slots[position].hash == hash
+        && hash_table_matches_key(t, t->slots[position].pair, p->hash, key, HASH_TABLE_WHOLE_KEY) == 1);
+
+    hash_table_robin_hood_shift_in(t->slots, t->size, incoming, position);
+    return p;
+}
+
+// Static function that empties the slot at the given position using backward shift
+// deletion: the following pairs that are displaced from their home are moved one slot
+// back, so no tombstones are ever left behind.
+static void hash_table_robin_hood_erase(const mads_hash_table_t *t, unsigned long long int position)
+{
+    unsigned long long int next = (position + 1 == t->size ? 0 : position + 1);
+
+    while (t->slots[next].pair != NULL && hash_table_probe_distance(next, t->slots[next].hash, t->size) > 0)
     {
-        return NULL;
+        t->slots[position] = t->slots[next];
+        position = next;
+        next = (next + 1 == t->size ? 0 : next + 1);
     }
+
+    t->slots[position].pair = NULL;
+    t->slots[position].hash = 0;
 }
 
 
-void mads_hash_table_change_value(const mads_hash_table_t *t, void *key, void *value)
+// Static function that searches a list bucket for the given key with the given hash code.
+// It returns the node holding the first pair of the key, or NULL if the key is not there.
+static mads_llnode_t *hash_table_list_find(const mads_hash_table_t *t,
+    const mads_list_t *list,
+    const unsigned long long int code,
+    const void *key,
+    const unsigned long long int length)
 {
-    assert(t != NULL);
-    mads_pair_t *returned_pair = NULL;
-    mads_cue_t temp_cue;
-    mads_pair_t temp_pair;
-    const mads_value_t *old_value = NULL;
-    mads_value_t *new_value = NULL;
-    if (mads_hash_table_lookup(t, key) == 0) { return; }
-    const unsigned long long int position = t->hash(t->hfunc, key);
-    temp_cue.cue = key;
-    temp_pair.k = &temp_cue;
+    for (mads_llnode_t *node = (list != NULL ? list->head : NULL); node != NULL; node = node->next)
+    {
+        if (hash_table_matches_key(t, node->data, code, key, length) == 1) { return node; }
+    }
+
+    return NULL;
+}
 
+// Static function that searches the bucket at the given position of a bucket array for the
+// given key with the given hash code. It returns the pair holding the key, or NULL if the key
+// is not in the bucket. Tree buckets are ordered by the keys, so their search needs the
+// comparator at every node.
+static mads_pair_t *hash_table_bucket_find(const mads_hash_table_t *t,
+    void *const *A,
+    const unsigned long long int position,
+    const unsigned long long int code,
+    const void *key,
+    const unsigned long long int length)
+{
+    const void *bucket = A[position];
+    const int bucket_type = hash_table_bucket_type(t, A, position);
+    if (bucket == NULL) { return NULL; }
 
-    if (t->chain_type == MADS_HASH_TABLE_CHAIN_LIST)
+    if (bucket_type == MADS_HASH_TABLE_CHAIN_LIST)
     {
-        const unsigned long long int chain_query = mads_list_has_elem(t->A[position], &temp_pair);
-        returned_pair = mads_list_get_at(t->A[position], chain_query);
-        old_value = mads_pair_get_value(returned_pair);
-        new_value = mads_value_create(value, old_value->comparator, old_value->printer, old_value->destructor);
-        mads_pair_change_value(returned_pair, new_value);
+        const mads_llnode_t *node = hash_table_list_find(t, bucket, code, key, length);
+        if (node != NULL) { return node->data; }
     }
-    else if (t->chain_type == MADS_HASH_TABLE_CHAIN_TREE)
+    else if (bucket_type == MADS_HASH_TABLE_CHAIN_TREE)
     {
-        returned_pair = mads_avl_tree_get_elem(t->A[position], &temp_pair);
-        old_value = mads_pair_get_value(returned_pair);
-        new_value = mads_value_create(value, old_value->comparator, old_value->printer, old_value->destructor);
-        mads_pair_change_value(returned_pair, new_value);
+        const mads_avl_tree_t *tree = bucket;
+        const mads_avl_node_t *node = tree->root;
+
+        while (node != NULL)
+        {
+            const int compare = hash_table_compare_key(t, node->data, key, length);
+            if (compare == 0) { return node->data; }
+            node = (compare > 0 ? node->left : node->right);
+        }
     }
+
+    return NULL;
 }
 
-void mads_hash_table_clear(mads_hash_table_t *t)
+// Static function that locates the bucket array and position of the bucket holding, or due
+// to hold, the key with the given hash code. While an incremental resize is in progress, keys
+// whose old bucket has not been migrated yet still live in the old bucket array; every other
+// key lives in the current one. Robin Hood tables have no bucket array: NULL is returned and
+// the position is the home slot.
+static void **hash_table_locate(const mads_hash_table_t *t, const unsigned long long int code, unsigned long long int *position)
 {
-    // TODO: Implement clearing of the hash table.
-}
+    if (t->chain_type == MADS_HASH_TABLE_OPEN_ROBIN_HOOD)
+    {
+        *position = hash_table_reduce(t, code, t->size);
+        return NULL;
+    }
 
+    if (t->old_A != NULL)
+    {
+        const unsigned long long int old_position = hash_table_reduce(t, code, t->old_size);
 
-void mads_hash_table_print(const mads_hash_table_t *t)
+        if (old_position >= t->migrate_pos)
+        {
+            *position = old_position;
+            return t->old_A;
+        }
+    }
+
+    *position = hash_table_reduce(t, code, t->size);
+    return t->A;
+}
+
+// Static function that moves the pairs of one bucket of the old bucket array into the
+// current bucket array, then releases the emptied bucket container. The new position of
+// every pair is derived from its cached hash code, so no key is hashed again.
+static void hash_table_migrate_bucket(mads_hash_table_t *t, const unsigned long long int i)
 {
-    assert(t != NULL);
+    mads_pair_t *temp_pair = NULL;
+    mads_list_t *temp_list = NULL;
+    mads_avl_tree_t *temp_tree = NULL;
+    unsigned long long int position;
 
-    for (unsigned long long int i = 0; i < t->size; i++)
+    if (t->old_A[i] == NULL) { return; }
+
+    if (hash_table_bucket_type(t, t->old_A, i) == MADS_HASH_TABLE_CHAIN_LIST)
     {
-        printf("index %lld:", i);
+        temp_list = t->old_A[i];
+        temp_list->destroy = NULL;
 
-        if (t->chain_type == MADS_HASH_TABLE_CHAIN_LIST)
+        while (!mads_list_is_empty(temp_list))
         {
-            mads_list_print(t->A[i]);
+            temp_pair = mads_list_get_head(temp_list);
+            position = hash_table_reduce(t, temp_pair->hash, t->size);
+            hash_table_bucket_add(t, t->A, position, temp_pair);
+            mads_list_remove_head(temp_list);
         }
-        else if (t->chain_type == MADS_HASH_TABLE_CHAIN_TREE)
+
+        mads_list_free(&temp_list);
+    }
+    else
+    {
+        temp_tree = t->old_A[i];
+        temp_tree->destroy = NULL;
+
+        while (!mads_avl_tree_is_empty(temp_tree))
         {
-            mads_avl_tree_print(t->A[i]);
+            temp_pair = mads_avl_tree_get_root(temp_tree);
+            position = hash_table_reduce(t, temp_pair->hash, t->size);
+            hash_table_bucket_add(t, t->A, position, temp_pair);
+            mads_avl_tree_remove_root(temp_tree);
         }
+
+        mads_avl_tree_free(temp_tree);
     }
-}
 
+    t->old_A[i] = NULL;
+}
 
-void mads_hash_table_free(mads_hash_table_t **t)
+// Static function that migrates up to the given number of buckets of an in-progress resize
+// and releases the old bucket array once every bucket has been moved.
+static void hash_table_rehash_step(mads_hash_table_t *t, unsigned long long int buckets)
 {
-    assert(t != NULL);
+    if (t->old_A == NULL) { return; }
+    HASH_TABLE_TIMER_START(start);
 
-    for (unsigned long long int i = 0; i < (*t)->size; i++)
+    while (t->old_A != NULL && buckets > 0)
     {
-        if ((*t)->chain_type == MADS_HASH_TABLE_CHAIN_LIST)
-        {
-            mads_list_free((mads_list_t **)&(*t)->A[i]);
-        }
-        else if ((*t)->chain_type == MADS_HASH_TABLE_CHAIN_TREE)
+        hash_table_migrate_bucket(t, t->migrate_pos);
+        t->migrate_pos = t->migrate_pos + 1;
+        buckets = buckets - 1;
+
+        if (t->migrate_pos == t->old_size)
         {
-            mads_avl_tree_free((*t)->A[i]);
+            free(t->old_A);
+            t->old_A = NULL;
+            free(t->old_trees);
+            t->old_trees = NULL;
+            t->old_size = 0;
+            t->migrate_pos = 0;
         }
     }
 
+    HASH_TABLE_TIMER_STOP(t, start);
+}
+
+// Static function that starts resizing a chained hash table. The current bucket array
+// becomes the old one and an array of the given size takes its place. A bucket is only
+// allocated once a pair is moved or inserted into it, so a sparse table never pays for
+// its empty buckets and starting a resize stays cheap.
+static void hash_table_rehash_start(mads_hash_table_t *t, const unsigned long long int new_size)
+{
+    void **new_array = NULL;
+    assert(t->old_A == NULL);
+    HASH_TABLE_TIMER_START(start);
+
+    new_array = (void **)calloc(new_size, sizeof(void *));
+    assert(new_array != NULL);
+
+    // Every bucket of the new array of a hybrid table starts out as a list.
+    if (t->chain_type == MADS_HASH_TABLE_CHAIN_HYBRID)
+    {
+        t->old_trees = t->trees;
+        t->trees = (unsigned char *)calloc(new_size, sizeof(unsigned char));
+        assert(t->trees != NULL);
+    }
+
+    t->old_A = t->A;
+    t->old_size = t->size;
+    t->migrate_pos = 0;
+    t->A = new_array;
+    t->size = new_size;
+    hash_table_load_factor(t);
+    HASH_TABLE_TIMER_STOP(t, start);
+}
+
+// Static function that resizes a Robin Hood hash table, reinserting every pair into a new
+// slot array at the home slot derived from its cached hash code. Open addressing has no
+// buckets to migrate, so this is always done at once.
+static void hash_table_robin_hood_rehash(mads_hash_table_t *t, const unsigned long long int new_size)
+{
+    mads_hash_table_slot_t *new_slots = NULL;
+    mads_hash_table_slot_t temp_slot;
+    unsigned long long int first = 0;
+    HASH_TABLE_TIMER_START(start);
+    new_slots = (mads_hash_table_slot_t *)calloc(new_size, sizeof(mads_hash_table_slot_t));
+    assert(new_slots != NULL);
+
+    // The walk starts after an empty slot, so no run of slots wraps around the end of the
+    // array. The pairs of a multimap key are then reinserted one after the other and stay
+    // in consecutive slots. Insertions keep a slot free, but a full array would have none,
+    // and the walk then simply starts at slot zero.
+    while (first < t->size && t->slots[first].pair != NULL) { first++; }
+    if (first == t->size) { first = t->size - 1; }
+
+    for (unsigned long long int k = 1; k <= t->size; k++)
+    {
+        const unsigned long long int i = (first + k) % t->size;
+        if (t->slots[i].pair == NULL) { continue; }
+        temp_slot.pair = t->slots[i].pair;
+        temp_slot.hash = hash_table_reduce(t, temp_slot.pair->hash, new_size);
+        hash_table_robin_hood_place(new_slots, new_size, temp_slot, temp_slot.hash, 0);
+    }
+
+    free(t->slots);
+    t->slots = new_slots;
+    t->size = new_size;
+    hash_table_load_factor(t);
+    HASH_TABLE_TIMER_STOP(t, start);
+}
+
+// Static function that resizes the hash table to the given number of buckets. When eager
+// is set, or the rehash step is zero, every pair is moved at once; otherwise the resize is
+// only started here and the buckets are migrated a few at a time by the following
+// insertions and removals.
+static void hash_table_resize(mads_hash_table_t *t, const unsigned long long int new_size, const int eager)
+{
+    assert(t != NULL);
+    HASH_TABLE_COUNT(t, rehashes, 1);
+
+    if (t->chain_type == MADS_HASH_TABLE_OPEN_ROBIN_HOOD)
+    {
+        hash_table_robin_hood_rehash(t, new_size);
+        return;
+    }
+
+    // A new resize cannot start before the previous one has finished.
+    hash_table_rehash_step(t, t->old_size);
+
+    hash_table_rehash_start(t, new_size);
+    if (eager == 1 || t->options.rehash_step == 0) { hash_table_rehash_step(t, t->old_size); }
+}
+
+// Static function that computes the number of buckets needed to hold the given number of
+// elements without exceeding the given maximum load factor.
+static unsigned long long int hash_table_buckets_for(const double max_load_factor, const unsigned long long int n)
+{
+    return (unsigned long long int)((double)n / max_load_factor) + 1;
+}
+
+// Static function that grows the hash table by its growth factor, and further if needed to
+// hold the given number of elements under the maximum load factor. A batch may add more
+// pairs than a small growth factor makes room for, and a full Robin Hood table never
+// finds an empty slot.
+static void hash_table_rehash(mads_hash_table_t *t, const unsigned long long int n)
+{
+    assert(t != NULL);
+    const unsigned long long int grown = (unsigned long long int)((double)t->size * t->options.growth_factor);
+    const unsigned long long int needed = hash_table_buckets_for(t->options.max_load_factor, n);
+    const unsigned long long int buckets = (grown > t->size ? grown : t->size + 1);
+    hash_table_resize(t, hash_table_fit_size(t, (needed > buckets ? needed : buckets)), 0);
+}
+
+// Static function that computes the size of the bucket array holding the given number of
+// elements at the given fraction of the maximum load factor, never below the initial size.
+static unsigned long long int hash_table_shrunk_size(const mads_hash_table_t *t,
+    const unsigned long long int n,
+    const unsigned long long int slack)
+{
+    const unsigned long long int buckets = hash_table_buckets_for(t->options.max_load_factor, n) * slack;
+    return hash_table_fit_size(t, (buckets > MADS_HASH_TABLE_INITIAL_SIZE ? buckets : MADS_HASH_TABLE_INITIAL_SIZE));
+}
+
+// Static function that shrinks the hash table once a removal takes its load factor below the
+// low-water mark. The table is resized to twice the buckets its elements need, i.e. to half
+// the maximum load factor, so it sits between both thresholds and does not thrash.
+static void hash_table_shrink(mads_hash_table_t *t)
+{
+    if (t->options.min_load_factor <= 0 || t->load_factor >= t->options.min_load_factor) { return; }
+    const unsigned long long int new_size = hash_table_shrunk_size(t, t->n, 2);
+    if (new_size < t->size) { hash_table_resize(t, new_size, 0); }
+}
+
+// Static function that raises the number of buckets an update migrates, if needed, so the
+// migration ends within the updates left before the table resizes again: the headroom, in
+// pairs, divided by the pairs each update adds or removes, plus the update running now. With a
+// small rehash step the next resize would otherwise finish the migration at once, the very
+// pause the incremental resize exists to avoid.
+static unsigned long long int hash_table_migration_step(const mads_hash_table_t *t,
+    const unsigned long long int step,
+    const double headroom,
+    const unsigned long long int count)
+{
+    if (t->old_A == NULL) { return step; }
+    const unsigned long long int remaining = t->old_size - t->migrate_pos;
+    const unsigned long long int updates = (headroom > 0 ? (unsigned long long int)headroom / count : 0) + 1;
+    const unsigned long long int needed = (remaining + updates - 1) / updates;
+    return (needed > step ? needed : step);
+}
+
+// Static function that prepares the hash table for the insertion of the given number of
+// pairs. It performs the migration owed by those insertions and grows the table if they
+// would exceed the maximum load factor, so no bucket moves while the pairs are inserted.
+static void hash_table_prepare_insert(mads_hash_table_t *t, const unsigned long long int count)
+{
+    const double headroom = (double)t->size * t->options.max_load_factor - (double)t->n;
+    hash_table_rehash_step(t, hash_table_migration_step(t, t->options.rehash_step * count, headroom, count));
+    // A Robin Hood table also grows before its last free slot is taken, whatever the load factor
+    // rounds to, since every probe ends at a free slot.
+    if ((double)(t->n + count) > (double)t->size * t->options.max_load_factor
+        || (t->chain_type == MADS_HASH_TABLE_OPEN_ROBIN_HOOD && t->n + count >= t->size))
+    {
+        hash_table_rehash(t, t->n + count);
+    }
+}
+
+// Static function that inserts the given pair, whose hash code is already cached, into the
+// bucket (or home slot) found by hash_table_locate, unless its key is already there. It
+// returns the pair stored for the key.
+static mads_pair_t *hash_table_insert_at(mads_hash_table_t *t,
+    mads_pair_t *p,
+    void **A,
+    const unsigned long long int position)
+{
+    mads_pair_t *stored_pair = NULL;
+    const void *cue_data = mads_cue_get(mads_pair_get_cue(p));
+
+    if (t->chain_type == MADS_HASH_TABLE_OPEN_ROBIN_HOOD)
+    {
+        stored_pair = hash_table_robin_hood_find_or_place(t, p, position, cue_data);
+    }
+    else if (hash_table_bucket_type(t, A, position) == MADS_HASH_TABLE_CHAIN_LIST)
+    {
+        mads_list_t *list = hash_table_get_bucket(t, A, position);
+        mads_llnode_t *node = hash_table_list_find(t, list, p->hash, cue_data, HASH_TABLE_WHOLE_KEY);
+
+        if (node == NULL) { hash_table_bucket_add(t, A, position, p); }
+        else if (t->options.multimap == 1) { mads_list_insert_after(list, node, p); }
+        stored_pair = (node == NULL || t->options.multimap == 1 ? p : node->data);
+    }
+    else
+    {
+        stored_pair = mads_avl_tree_find_or_insert(hash_table_get_bucket(t, A, position), p);
+    }
+
+    if (stored_pair == p) { t->n = t->n + 1; }
+    hash_table_load_factor(t);
+    return stored_pair;
+}
+
+// Static function that searches the bucket (or home slot) found by hash_table_locate for
+// the given key. It returns the pair holding the key, or NULL if the key does not exist.
+static mads_pair_t *hash_table_find_at(const mads_hash_table_t *t,
+    void **A,
+    const unsigned long long int position,
+    const unsigned long long int code,
+    const void *key,
+    const unsigned long long int length)
+{
+    mads_pair_t *pair = NULL;
+
+    if (t->chain_type == MADS_HASH_TABLE_OPEN_ROBIN_HOOD)
+    {
+        const unsigned long long int found = hash_table_robin_hood_find(t, position, code, key, length);
+        pair = (found < t->size ? t->slots[found].pair : NULL);
+    }
+    else
+    {
+        pair = hash_table_bucket_find(t, A, position, code, key, length);
+    }
+
+    HASH_TABLE_COUNT(t, lookups, 1);
+    if (pair != NULL) { HASH_TABLE_COUNT(t, hits, 1); }
+    else { HASH_TABLE_COUNT(t, misses, 1); }
+    return pair;
+}
+
+// Static function that locates the buckets of a group of keys. Every key is hashed first
+// and the memory holding its bucket pointer (or slot) is prefetched; then the bucket
+// containers (or stored pairs) themselves are prefetched. The cache misses of the whole
+// group thus overlap, instead of being paid one key at a time when the group is resolved.
+static void hash_table_locate_batch(const mads_hash_table_t *t,
+    const void *const *keys,
+    const unsigned long long int group,
+    void ***arrays,
+    unsigned long long int *positions,
+    unsigned long long int *codes)
+{
+    for (unsigned long long int i = 0; i < group; i++)
+    {
+        codes[i] = hash_table_code(t, keys[i], HASH_TABLE_WHOLE_KEY);
+        arrays[i] = hash_table_locate(t, codes[i], &positions[i]);
+
+        if (arrays[i] != NULL) { HASH_TABLE_PREFETCH(&arrays[i][positions[i]]); }
+        else { HASH_TABLE_PREFETCH(&t->slots[positions[i]]); }
+    }
+
+    for (unsigned long long int i = 0; i < group; i++)
+    {
+        const void *bucket = (arrays[i] != NULL ? arrays[i][positions[i]] : t->slots[positions[i]].pair);
+        if (bucket != NULL) { HASH_TABLE_PREFETCH(bucket); }
+    }
+}
+
+// Static function that creates a hash table whose bucket array holds at least the given
+// number of buckets.
+static mads_hash_table_t *hash_table_create(const mads_hash_table_hash_fn hash,
+    const int chain_type,
+    const mads_hash_table_options_t *options,
+    const unsigned long long int buckets)
+{
+    mads_hash_table_t *new_table = NULL;
+    assert(hash != NULL);
+    assert(chain_type == MADS_HASH_TABLE_CHAIN_LIST
+        || chain_type == MADS_HASH_TABLE_CHAIN_TREE
+        || chain_type == MADS_HASH_TABLE_CHAIN_HYBRID
+        || chain_type == MADS_HASH_TABLE_OPEN_ROBIN_HOOD);
+
+    new_table = (mads_hash_table_t *)malloc(sizeof(*new_table));
+    assert(new_table != NULL);
+
+    new_table->A = NULL;
+    new_table->slots = NULL;
+    new_table->trees = NULL;
+    new_table->old_trees = NULL;
+    new_table->chain_type = chain_type;
+    new_table->options = (options != NULL ? *options : mads_hash_table_default_options());
+    assert(new_table->options.sizing == MADS_HASH_TABLE_SIZING_PRIME
+        || new_table->options.sizing == MADS_HASH_TABLE_SIZING_POW2);
+    assert(new_table->options.max_load_factor > 0);
+    assert(new_table->options.max_load_factor < 1 || chain_type != MADS_HASH_TABLE_OPEN_ROBIN_HOOD);
+    assert(new_table->options.min_load_factor >= 0
+        && new_table->options.min_load_factor < new_table->options.max_load_factor / 4);
+    assert(new_table->options.growth_factor > 1);
+    assert(new_table->options.multimap == 0
+        || (new_table->options.multimap == 1
+            && (chain_type == MADS_HASH_TABLE_CHAIN_LIST || chain_type == MADS_HASH_TABLE_OPEN_ROBIN_HOOD)));
+    new_table->size = hash_table_fit_size(new_table, buckets);
+
+    if (new_table->chain_type == MADS_HASH_TABLE_OPEN_ROBIN_HOOD)
+    {
+        new_table->slots = (mads_hash_table_slot_t *)calloc(new_table->size, sizeof(mads_hash_table_slot_t));
+        assert(new_table->slots != NULL);
+    }
+    else
+    {
+        // Buckets start out empty and are allocated by the first insertion into them.
+        new_table->A = (void **)calloc(new_table->size, sizeof(void *));
+        assert(new_table->A != NULL);
+    }
+
+    if (new_table->chain_type == MADS_HASH_TABLE_CHAIN_HYBRID)
+    {
+        new_table->trees = (unsigned char *)calloc(new_table->size, sizeof(unsigned char));
+        assert(new_table->trees != NULL);
+    }
+
+    new_table->n = 0;
+    new_table->load_factor = (double)(new_table->n) / (new_table->size);
+    new_table->hfunc = mads_uni_hash_create_pow2(MADS_HASH_TABLE_HASH_RANGE, 20);
+    new_table->hash = hash;
+    new_table->old_A = NULL;
+    new_table->old_size = 0;
+    new_table->migrate_pos = 0;
+    new_table->counters = NULL;
+
+#ifdef MADS_HASH_TABLE_STATS
+    new_table->counters = calloc(1, sizeof(*new_table->counters));
+    assert(new_table->counters != NULL);
+#endif
+
+    return new_table;
+}
+
+
+mads_hash_table_options_t mads_hash_table_default_options(void)
+{
+    mads_hash_table_options_t options;
+    options.rehash_step = 0;
+    options.sizing = MADS_HASH_TABLE_SIZING_PRIME;
+    options.min_load_factor = 0;
+    options.max_load_factor = MADS_HASH_TABLE_MAX_LOAD_FACTOR;
+    options.growth_factor = MADS_HASH_TABLE_GROWTH_FACTOR;
+    options.hash_by = NULL;
+    options.compare_by = NULL;
+    options.multimap = 0;
+    return options;
+}
+
+
+mads_hash_table_t *mads_hash_table_create(const mads_hash_table_hash_fn hash, const int chain_type)
+{
+    return hash_table_create(hash, chain_type, NULL, MADS_HASH_TABLE_INITIAL_SIZE);
+}
+
+
+mads_hash_table_t *mads_hash_table_create_with_options(const mads_hash_table_hash_fn hash,
+    const int chain_type,
+    const mads_hash_table_options_t *options)
+{
+    return hash_table_create(hash, chain_type, options, MADS_HASH_TABLE_INITIAL_SIZE);
+}
+
+
+mads_hash_table_t *mads_hash_table_create_with_capacity(const mads_hash_table_hash_fn hash,
+    const int chain_type,
+    const unsigned long long int capacity,
+    const mads_hash_table_options_t *options)
+{
+    // The table is sized for the load factor it will grow at, like mads_hash_table_reserve.
+    const double max_load_factor = (options != NULL ? options->max_load_factor : MADS_HASH_TABLE_MAX_LOAD_FACTOR);
+    assert(max_load_factor > 0);
+    const unsigned long long int buckets = hash_table_buckets_for(max_load_factor, capacity);
+    return hash_table_create(hash, chain_type, options, (buckets > MADS_HASH_TABLE_INITIAL_SIZE ? buckets : MADS_HASH_TABLE_INITIAL_SIZE));
+}
+
+
+void mads_hash_table_reserve(mads_hash_table_t *t, const unsigned long long int capacity)
+{
+    assert(t != NULL);
+    const unsigned long long int new_size = hash_table_fit_size(t, hash_table_buckets_for(t->options.max_load_factor, capacity));
+
+    // Reserving is an explicit bulk operation, so the pairs are moved at once.
+    if (new_size > t->size) { hash_table_resize(t, new_size, 1); }
+}
+
+
+void mads_hash_table_shrink_to_fit(mads_hash_table_t *t)
+{
+    assert(t != NULL);
+    const unsigned long long int new_size = hash_table_shrunk_size(t, t->n, 1);
+
+    // Shrinking is an explicit bulk operation, so the pairs are moved at once.
+    if (new_size < t->size) { hash_table_resize(t, new_size, 1); }
+    hash_table_rehash_step(t, t->old_size);
+}
+
+
+mads_pair_t *mads_hash_table_find_or_insert(mads_hash_table_t *t, mads_pair_t *p, int *inserted)
+{
+    assert(t != NULL && p != NULL);
+    mads_pair_t *stored_pair = NULL;
+    unsigned long long int position;
+    hash_table_prepare_insert(t, 1);
+    p->hash = hash_table_code(t, mads_cue_get(mads_pair_get_cue(p)), HASH_TABLE_WHOLE_KEY);
+    void **A = hash_table_locate(t, p->hash, &position);
+    stored_pair = hash_table_insert_at(t, p, A, position);
+    if (inserted != NULL) { *inserted = (stored_pair == p ? 1 : 0); }
+    return stored_pair;
+}
+
+
+void mads_hash_table_insert(mads_hash_table_t *t, mads_pair_t *p)
+{
+    mads_hash_table_find_or_insert(t, p, NULL);
+}
+
+
+void mads_hash_table_insert_batch(mads_hash_table_t *t, mads_pair_t **pairs, const unsigned long long int count, int *inserted)
+{
+    assert(t != NULL && (pairs != NULL || count == 0));
+    const void *keys[MADS_HASH_TABLE_BATCH_GROUP];
+    void **arrays[MADS_HASH_TABLE_BATCH_GROUP];
+    unsigned long long int positions[MADS_HASH_TABLE_BATCH_GROUP];
+    unsigned long long int codes[MADS_HASH_TABLE_BATCH_GROUP];
+
+    for (unsigned long long int first = 0; first < count; first += MADS_HASH_TABLE_BATCH_GROUP)
+    {
+        const unsigned long long int group = (count - first < MADS_HASH_TABLE_BATCH_GROUP ? count - first : MADS_HASH_TABLE_BATCH_GROUP);
+
+        // No resize or migration may happen in the middle of a group, as it would move the located buckets.
+        hash_table_prepare_insert(t, group);
+
+        for (unsigned long long int i = 0; i < group; i++)
+        {
+            keys[i] = mads_cue_get(mads_pair_get_cue(pairs[first + i]));
+        }
+
+        hash_table_locate_batch(t, keys, group, arrays, positions, codes);
+
+        for (unsigned long long int i = 0; i < group; i++)
+        {
+            pairs[first + i]->hash = codes[i];
+            mads_pair_t *stored_pair = hash_table_insert_at(t, pairs[first + i], arrays[i], positions[i]);
+            if (inserted != NULL) { inserted[first + i] = (stored_pair == pairs[first + i] ? 1 : 0); }
+        }
+    }
+}
+
+
+mads_pair_t *mads_hash_table_find(const mads_hash_table_t *t, const void *key)
+{
+    assert(t != NULL);
+    unsigned long long int position;
+    const unsigned long long int code = hash_table_code(t, key, HASH_TABLE_WHOLE_KEY);
+    void **A = hash_table_locate(t, code, &position);
+    return hash_table_find_at(t, A, position, code, key, HASH_TABLE_WHOLE_KEY);
+}
+
+
+void mads_hash_table_get_values_batch(const mads_hash_table_t *t, void **keys, const unsigned long long int count, void **values)
+{
+    assert(t != NULL && ((keys != NULL && values != NULL) || count == 0));
+    void **arrays[MADS_HASH_TABLE_BATCH_GROUP];
+    unsigned long long int positions[MADS_HASH_TABLE_BATCH_GROUP];
+    unsigned long long int codes[MADS_HASH_TABLE_BATCH_GROUP];
+
+    for (unsigned long long int first = 0; first < count; first += MADS_HASH_TABLE_BATCH_GROUP)
+    {
+        const unsigned long long int group = (count - first < MADS_HASH_TABLE_BATCH_GROUP ? count - first : MADS_HASH_TABLE_BATCH_GROUP);
+        hash_table_locate_batch(t, (const void *const *)&keys[first], group, arrays, positions, codes);
+
+        for (unsigned long long int i = 0; i < group; i++)
+        {
+            const mads_pair_t *pair = hash_table_find_at(t, arrays[i], positions[i], codes[i], keys[first + i], HASH_TABLE_WHOLE_KEY);
+            values[first + i] = (pair != NULL ? mads_value_get(mads_pair_get_value(pair)) : NULL);
+        }
+    }
+}
+
+
+mads_pair_t *mads_hash_table_find_by(const mads_hash_table_t *t, const void *key, const unsigned long long int length)
+{
+    assert(t != NULL && t->options.hash_by != NULL && t->options.compare_by != NULL);
+    assert(length != HASH_TABLE_WHOLE_KEY);
+    unsigned long long int position;
+    const unsigned long long int code = hash_table_code(t, key, length);
+    void **A = hash_table_locate(t, code, &position);
+    return hash_table_find_at(t, A, position, code, key, length);
+}
+
+
+int mads_hash_table_lookup_by(const mads_hash_table_t *t, const void *key, const unsigned long long int length)
+{
+    return (mads_hash_table_find_by(t, key, length) != NULL ? 1 : 0);
+}
+
+
+void *mads_hash_table_get_value_by(const mads_hash_table_t *t, const void *key, const unsigned long long int length)
+{
+    const mads_pair_t *returned_pair = mads_hash_table_find_by(t, key, length);
+    if (returned_pair == NULL) { return NULL; }
+    return mads_value_get(mads_pair_get_value(returned_pair));
+}
+
+
+int mads_hash_table_lookup(const mads_hash_table_t *t, void *key)
+{
+    return (mads_hash_table_find(t, key) != NULL ? 1 : 0);
+}
+
+
+void mads_hash_table_equal_range(const mads_hash_table_t *t, const void *key, mads_hash_table_range_t *range)
+{
+    assert(t != NULL && range != NULL);
+    unsigned long long int position;
+    range->table = t;
+    range->key = key;
+    range->code = hash_table_code(t, key, HASH_TABLE_WHOLE_KEY);
+    range->pair = NULL;
+    range->node = NULL;
+    range->position = 0;
+    void **A = hash_table_locate(t, range->code, &position);
+
+    if (t->chain_type == MADS_HASH_TABLE_OPEN_ROBIN_HOOD)
+    {
+        range->position = hash_table_robin_hood_find(t, position, range->code, key, HASH_TABLE_WHOLE_KEY);
+        range->pair = (range->position < t->size ? t->slots[range->position].pair : NULL);
+    }
+    else if (hash_table_bucket_type(t, A, position) == MADS_HASH_TABLE_CHAIN_LIST)
+    {
+        const mads_llnode_t *node = hash_table_list_find(t, A[position], range->code, key, HASH_TABLE_WHOLE_KEY);
+        range->node = node;
+        range->pair = (node != NULL ? node->data : NULL);
+    }
+    else
+    {
+        range->pair = hash_table_bucket_find(t, A, position, range->code, key, HASH_TABLE_WHOLE_KEY);
+    }
+}
+
+
+mads_pair_t *mads_hash_table_range_next(mads_hash_table_range_t *range)
+{
+    assert(range != NULL);
+    const mads_hash_table_t *t = range->table;
+    mads_pair_t *pair = range->pair;
+    if (pair == NULL) { return NULL; }
+
+    // The pairs of a key are next to each other, so the run ends at the first other key.
+    // A list bucket keeps the node of the pair, a tree bucket holds a single pair per key.
+    range->pair = NULL;
+
+    if (range->node != NULL)
+    {
+        const mads_llnode_t *node = ((const mads_llnode_t *)range->node)->next;
+        range->node = node;
+
+        if (node != NULL && hash_table_matches_key(t, node->data, range->code, range->key, HASH_TABLE_WHOLE_KEY) == 1)
+        {
+            range->pair = node->data;
+        }
+    }
+    else if (t->chain_type == MADS_HASH_TABLE_OPEN_ROBIN_HOOD)
+    {
+        range->position = (range->position + 1 == t->size ? 0 : range->position + 1);
+        const mads_hash_table_slot_t *slot = &t->slots[range->position];
+
+        if (slot->pair != NULL && hash_table_matches_key(t, slot->pair, range->code, range->key, HASH_TABLE_WHOLE_KEY) == 1)
+        {
+            range->pair = slot->pair;
+        }
+    }
+
+    return pair;
+}
+
+
+unsigned long long int mads_hash_table_count(const mads_hash_table_t *t, const void *key)
+{
+    mads_hash_table_range_t range;
+    unsigned long long int count = 0;
+    mads_hash_table_equal_range(t, key, &range);
+    while (mads_hash_table_range_next(&range) != NULL) { count++; }
+    return count;
+}
+
+
+void mads_hash_table_remove(mads_hash_table_t *t, void *key)
+{
+    assert(t != NULL);
+    mads_pair_t temp_pair;
+    mads_cue_t temp_cue;
+    unsigned long long int position;
+
+    // Removals only resize the table when it shrinks, so only then do they have to keep pace.
+    if (t->options.min_load_factor > 0)
+    {
+        const double headroom = (double)t->n - (double)t->size * t->options.min_load_factor;
+        hash_table_rehash_step(t, hash_table_migration_step(t, t->options.rehash_step, headroom, 1));
+    }
+    else
+    {
+        hash_table_rehash_step(t, t->options.rehash_step);
+    }
+
+    const unsigned long long int code = hash_table_code(t, key, HASH_TABLE_WHOLE_KEY);
+
+    if (t->chain_type == MADS_HASH_TABLE_OPEN_ROBIN_HOOD)
+    {
+        position = hash_table_robin_hood_find(t, hash_table_reduce(t, code, t->size), code, key, HASH_TABLE_WHOLE_KEY);
+
+        if (position < t->size)
+        {
+            hash_table_deallocate_pair(t->slots[position].pair);
+            hash_table_robin_hood_erase(t, position);
+            t->n = t->n - 1;
+        }
+    }
+    else
+    {
+        void **A = hash_table_locate(t, code, &position);
+
+        if (hash_table_bucket_type(t, A, position) == MADS_HASH_TABLE_CHAIN_LIST)
+        {
+            mads_list_t *list = A[position];
+            mads_llnode_t *node = hash_table_list_find(t, list, code, key, HASH_TABLE_WHOLE_KEY);
+
+            if (node != NULL)
+            {
+                mads_list_remove_node(list, node);
+                t->n = t->n - 1;
+            }
+        }
+        else if (A[position] != NULL)
+        {
+            temp_cue.cue = key;
+            temp_pair.k = &temp_cue;
+            if (mads_avl_tree_remove(A[position], &temp_pair) == 1) { t->n = t->n - 1; }
+
+            // A tree bucket of a hybrid table that has become short enough is walked faster as a list.
+            if (t->chain_type == MADS_HASH_TABLE_CHAIN_HYBRID && mads_avl_tree_get_height(A[position]) <= MADS_HASH_TABLE_UNTREEIFY_HEIGHT)
+            {
+                hash_table_untreeify(t, A, position);
+            }
+        }
+    }
+
+    hash_table_load_factor(t);
+    hash_table_shrink(t);
+}
+
+
+void *mads_hash_table_get_value(const mads_hash_table_t *t, void *key)
+{
+    const mads_pair_t *returned_pair = mads_hash_table_find(t, key);
+    if (returned_pair == NULL) { return NULL; }
+    return mads_value_get(mads_pair_get_value(returned_pair));
+}
+
+
+void mads_hash_table_change_value(const mads_hash_table_t *t, void *key, void *value)
+{
+    const mads_value_t *old_value = NULL;
+    mads_value_t *new_value = NULL;
+    mads_pair_t *returned_pair = mads_hash_table_find(t, key);
+    if (returned_pair == NULL) { return; }
+
+    old_value = mads_pair_get_value(returned_pair);
+    new_value = mads_value_create(value, old_value->comparator, old_value->printer, old_value->destructor);
+    mads_pair_change_value(returned_pair, new_value);
+}
+
+void mads_hash_table_clear(mads_hash_table_t *t)
+{
+    assert(t != NULL);
+
+    for (unsigned long long int i = 0; i < t->size; i++)
+    {
+        if (t->chain_type == MADS_HASH_TABLE_OPEN_ROBIN_HOOD)
+        {
+            if (t->slots[i].pair != NULL) { hash_table_deallocate_pair(t->slots[i].pair); }
+            t->slots[i].pair = NULL;
+            t->slots[i].hash = 0;
+        }
+        else if (t->chain_type == MADS_HASH_TABLE_CHAIN_HYBRID
+            && hash_table_bucket_type(t, t->A, i) == MADS_HASH_TABLE_CHAIN_TREE)
+        {
+            // The tree buckets of a hybrid table are released, so they start over as lists.
+            hash_table_free_bucket(MADS_HASH_TABLE_CHAIN_TREE, t->A[i]);
+            t->A[i] = NULL;
+            hash_table_set_bucket_type(t, t->A, i, MADS_HASH_TABLE_CHAIN_LIST);
+        }
+        else
+        {
+            hash_table_empty_bucket(hash_table_bucket_type(t, t->A, i), t->A[i]);
+        }
+    }
+
+    // The old bucket array of an in-progress resize has nothing left to migrate.
+    for (unsigned long long int i = 0; t->old_A != NULL && i < t->old_size; i++)
+    {
+        hash_table_free_bucket(hash_table_bucket_type(t, t->old_A, i), t->old_A[i]);
+    }
+
+    free(t->old_A);
+    t->old_A = NULL;
+    free(t->old_trees);
+    t->old_trees = NULL;
+    t->old_size = 0;
+    t->migrate_pos = 0;
+    t->n = 0;
+    hash_table_load_factor(t);
+}
+
+
+void mads_hash_table_clear_and_shrink(mads_hash_table_t *t)
+{
+    assert(t != NULL);
+    const unsigned long long int new_size = hash_table_fit_size(t, MADS_HASH_TABLE_INITIAL_SIZE);
+    mads_hash_table_clear(t);
+    if (t->size <= new_size) { return; }
+
+    if (t->chain_type == MADS_HASH_TABLE_OPEN_ROBIN_HOOD)
+    {
+        free(t->slots);
+        t->slots = (mads_hash_table_slot_t *)calloc(new_size, sizeof(mads_hash_table_slot_t));
+        assert(t->slots != NULL);
+    }
+    else
+    {
+        // The leading bucket containers are empty now and are kept, the others are released.
+        for (unsigned long long int i = new_size; i < t->size; i++)
+        {
+            hash_table_free_bucket(hash_table_bucket_type(t, t->A, i), t->A[i]);
+        }
+
+        void **new_array = (void **)realloc(t->A, new_size * sizeof(void *));
+        assert(new_array != NULL);
+        t->A = new_array;
+
+        if (t->trees != NULL)
+        {
+            unsigned char *new_trees = (unsigned char *)realloc(t->trees, new_size * sizeof(unsigned char));
+            assert(new_trees != NULL);
+            t->trees = new_trees;
+        }
+    }
+
+    t->size = new_size;
+    hash_table_load_factor(t);
+}
+
+
+// Static function that pushes the given tree node and its chain of left children on the
+// node stack of the iterator, so the smallest pending node ends up on top.
+static void hash_table_iter_push_left(mads_hash_table_iter_t *it, const mads_avl_node_t *node)
+{
+    while (node != NULL)
+    {
+        assert(it->depth < MADS_HASH_TABLE_ITER_STACK);
+        it->stack[it->depth] = node;
+        it->depth = it->depth + 1;
+        node = node->left;
+    }
+}
+
+
+void mads_hash_table_iter_init(mads_hash_table_iter_t *it, const mads_hash_table_t *t)
+{
+    assert(it != NULL && t != NULL);
+    it->table = t;
+    it->in_old = 0;
+    it->bucket = 0;
+    it->node = NULL;
+    it->depth = 0;
+}
+
+
+mads_pair_t *mads_hash_table_iter_next(mads_hash_table_iter_t *it)
+{
+    assert(it != NULL);
+    const mads_hash_table_t *t = it->table;
+
+    while (1)
+    {
+        // Resume inside the current bucket first.
+        if (it->node != NULL)
+        {
+            const mads_llnode_t *node = it->node;
+            it->node = node->next;
+            return node->data;
+        }
+
+        if (it->depth > 0)
+        {
+            it->depth = it->depth - 1;
+            const mads_avl_node_t *node = it->stack[it->depth];
+            hash_table_iter_push_left(it, node->right);
+            return node->data;
+        }
+
+        // Then move on to the next bucket, and from the current bucket array to the
+        // not yet migrated buckets of an in-progress resize.
+        if (it->in_old == 0 && it->bucket >= t->size)
+        {
+            it->in_old = 1;
+            it->bucket = t->migrate_pos;
+        }
+
+        if (it->in_old == 1 && (t->old_A == NULL || it->bucket >= t->old_size)) { return NULL; }
+
+        const unsigned long long int i = it->bucket;
+        it->bucket = it->bucket + 1;
+
+        if (t->chain_type == MADS_HASH_TABLE_OPEN_ROBIN_HOOD)
+        {
+            if (t->slots[i].pair != NULL) { return t->slots[i].pair; }
+            continue;
+        }
+
+        void *const *A = (it->in_old == 0 ? t->A : t->old_A);
+        const void *bucket = A[i];
+        if (bucket == NULL) { continue; }
+
+        if (hash_table_bucket_type(t, A, i) == MADS_HASH_TABLE_CHAIN_LIST)
+        {
+            it->node = ((const mads_list_t *)bucket)->head;
+        }
+        else
+        {
+            hash_table_iter_push_left(it, ((const mads_avl_tree_t *)bucket)->root);
+        }
+    }
+}
+
+
+void mads_hash_table_for_each(const mads_hash_table_t *t, const mads_hash_table_visit_fn fn, void *ctx)
+{
+    mads_hash_table_iter_t it;
+    mads_pair_t *pair = NULL;
+    assert(t != NULL && fn != NULL);
+    mads_hash_table_iter_init(&it, t);
+
+    while ((pair = mads_hash_table_iter_next(&it)) != NULL)
+    {
+        fn(pair, ctx);
+    }
+}
+
+
+// Static function that counts the nodes of a tree bucket.
+static unsigned long long int hash_table_tree_count(const mads_avl_node_t *node)
+{
+    if (node == NULL) { return 0; }
+    return 1 + hash_table_tree_count(node->left) + hash_table_tree_count(node->right);
+}
+
+// Static function that adds a chain of the given length to the statistics, with the total
+// number of pairs of the used buckets accumulated into total.
+static void hash_table_stats_chain(const unsigned long long int length,
+    mads_hash_table_stats_t *stats,
+    unsigned long long int *total)
+{
+    const unsigned long long int bin = (length < MADS_HASH_TABLE_STATS_HISTOGRAM ? length : MADS_HASH_TABLE_STATS_HISTOGRAM - 1);
+    stats->histogram[bin] = stats->histogram[bin] + 1;
+    if (length == 0) { return; }
+    stats->used_buckets = stats->used_buckets + 1;
+    if (length > stats->max_chain_length) { stats->max_chain_length = length; }
+    *total = *total + length;
+}
+
+// Static function that adds the chain of one bucket container to the statistics.
+static void hash_table_stats_bucket(const int chain_type,
+    const void *bucket,
+    mads_hash_table_stats_t *stats,
+    unsigned long long int *total)
+{
+    unsigned long long int length = 0;
+
+    if (bucket != NULL && chain_type == MADS_HASH_TABLE_CHAIN_LIST)
+    {
+        length = mads_list_size(bucket);
+    }
+    else if (bucket != NULL && chain_type == MADS_HASH_TABLE_CHAIN_TREE)
+    {
+        length = hash_table_tree_count(((const mads_avl_tree_t *)bucket)->root);
+    }
+
+    hash_table_stats_chain(length, stats, total);
+}
+
+
+mads_hash_table_stats_t mads_hash_table_stats(const mads_hash_table_t *t)
+{
+    mads_hash_table_stats_t stats;
+    unsigned long long int total = 0;
+    assert(t != NULL);
+
+    stats.n = t->n;
+    stats.size = t->size;
+    stats.load_factor = (double)t->n / (double)t->size;
+    stats.used_buckets = 0;
+    stats.average_chain_length = 0;
+    stats.max_chain_length = 0;
+    for (unsigned long long int i = 0; i < MADS_HASH_TABLE_STATS_HISTOGRAM; i++) { stats.histogram[i] = 0; }
+    stats.counters = mads_hash_table_get_counters(t);
+
+    for (unsigned long long int i = 0; i < t->size; i++)
+    {
+        if (t->chain_type == MADS_HASH_TABLE_OPEN_ROBIN_HOOD)
+        {
+            const mads_hash_table_slot_t *slot = &t->slots[i];
+            hash_table_stats_chain((slot->pair != NULL ? hash_table_probe_distance(i, slot->hash, t->size) + 1 : 0), &stats, &total);
+        }
+        else
+        {
+            hash_table_stats_bucket(hash_table_bucket_type(t, t->A, i), t->A[i], &stats, &total);
+        }
+    }
+
+    for (unsigned long long int i = t->migrate_pos; t->old_A != NULL && i < t->old_size; i++)
+    {
+        hash_table_stats_bucket(hash_table_bucket_type(t, t->old_A, i), t->old_A[i], &stats, &total);
+    }
+
+    if (stats.used_buckets > 0) { stats.average_chain_length = (double)total / (double)stats.used_buckets; }
+    return stats;
+}
+
+
+mads_hash_table_counters_t mads_hash_table_get_counters(const mads_hash_table_t *t)
+{
+    mads_hash_table_counters_t counters = { 0 };
+    assert(t != NULL);
+
+#ifdef MADS_HASH_TABLE_STATS
+    counters.lookups = atomic_load_explicit(&t->counters->lookups, memory_order_relaxed);
+    counters.hits = atomic_load_explicit(&t->counters->hits, memory_order_relaxed);
+    counters.misses = atomic_load_explicit(&t->counters->misses, memory_order_relaxed);
+    counters.comparisons = atomic_load_explicit(&t->counters->comparisons, memory_order_relaxed);
+    counters.rehashes = atomic_load_explicit(&t->counters->rehashes, memory_order_relaxed);
+    counters.rehash_nanoseconds = atomic_load_explicit(&t->counters->rehash_nanoseconds, memory_order_relaxed);
+#endif
+
+    return counters;
+}
+
+
+void mads_hash_table_reset_counters(const mads_hash_table_t *t)
+{
+    assert(t != NULL);
+
+#ifdef MADS_HASH_TABLE_STATS
+    atomic_store_explicit(&t->counters->lookups, 0, memory_order_relaxed);
+    atomic_store_explicit(&t->counters->hits, 0, memory_order_relaxed);
+    atomic_store_explicit(&t->counters->misses, 0, memory_order_relaxed);
+    atomic_store_explicit(&t->counters->comparisons, 0, memory_order_relaxed);
+    atomic_store_explicit(&t->counters->rehashes, 0, memory_order_relaxed);
+    atomic_store_explicit(&t->counters->rehash_nanoseconds, 0, memory_order_relaxed);
+#endif
+}
+
+
+void mads_hash_table_print(const mads_hash_table_t *t)
+{
+    assert(t != NULL);
+
+    for (unsigned long long int i = 0; i < t->size; i++)
+    {
+        printf("index %lld:", i);
+
+        if (t->chain_type == MADS_HASH_TABLE_OPEN_ROBIN_HOOD)
+        {
+            if (t->slots[i].pair == NULL)
+            {
+                printf("[]\n");
+                continue;
+            }
+
+            printf("[ ");
+            mads_pair_print(t->slots[i].pair);
+            printf(" ]\n");
+        }
+        else
+        {
+            hash_table_print_bucket(hash_table_bucket_type(t, t->A, i), t->A[i]);
+        }
+    }
+
+    // Buckets of an in-progress resize that have not been migrated yet.
+    for (unsigned long long int i = t->migrate_pos; t->old_A != NULL && i < t->old_size; i++)
+    {
+        printf("old index %lld:", i);
+        hash_table_print_bucket(hash_table_bucket_type(t, t->old_A, i), t->old_A[i]);
+    }
+}
+
+
+void mads_hash_table_free(mads_hash_table_t **t)
+{
+    assert(t != NULL);
+
+    for (unsigned long long int i = 0; i < (*t)->size; i++)
+    {
+        if ((*t)->chain_type == MADS_HASH_TABLE_OPEN_ROBIN_HOOD)
+        {
+            if ((*t)->slots[i].pair != NULL) { hash_table_deallocate_pair((*t)->slots[i].pair); }
+            (*t)->slots[i].pair = NULL;
+        }
+        else
+        {
+            hash_table_free_bucket(hash_table_bucket_type(*t, (*t)->A, i), (*t)->A[i]);
+            (*t)->A[i] = NULL;
+        }
+    }
+
+    for (unsigned long long int i = 0; (*t)->old_A != NULL && i < (*t)->old_size; i++)
+    {
+        hash_table_free_bucket(hash_table_bucket_type(*t, (*t)->old_A, i), (*t)->old_A[i]);
+        (*t)->old_A[i] = NULL;
+    }
+
     free((*t)->A);
     (*t)->A = NULL;
+    free((*t)->old_A);
+    (*t)->old_A = NULL;
+    free((*t)->trees);
+    (*t)->trees = NULL;
+    free((*t)->old_trees);
+    (*t)->old_trees = NULL;
+    free((*t)->slots);
+    (*t)->slots = NULL;
     mads_uni_hash_free(&(*t)->hfunc);
     (*t)->hfunc = NULL;
+    free((*t)->counters);
+    (*t)->counters = NULL;
     free(*t);
     *t = NULL;
 }
@@ -0,0 +1,289 @@
+// ReSharper disable CppDFANullDereference
+// ReSharper disable CppDFAMemoryLeak
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+// The loader maps the snapshot with the native file mapping API of the platform.
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include <mads/algorithms/hash.h>
+#include <mads/data_structures/hash_table_snapshot.h>
+
+
+// Every number of the file is stored as an eight byte word.
+static_assert(sizeof(unsigned long long int) == 8, "snapshot words must be eight bytes");
+
+// The header words: magic, number of pairs, number of buckets and the hashing seeds.
+#define SNAPSHOT_HEADER_WORDS (3 + MADS_UNI_HASH_SEEDS)
+
+// The words preceding the key and value bytes of an entry: hash, key length and value length.
+#define SNAPSHOT_ENTRY_WORDS 3
+
+
+// Static function that computes the length of an entry holding the given key and value
+// lengths, padded so the next entry starts on an eight byte boundary.
+static unsigned long long int snapshot_entry_length(const unsigned long long int key_length,
+    const unsigned long long int value_length)
+{
+    return SNAPSHOT_ENTRY_WORDS * 8 + ((key_length + value_length + 7) & ~7ULL);
+}
+
+// Static function that maps the whole file at the given path read only. It returns the
+// mapping and its length, or NULL if the file cannot be opened or mapped.
+static const unsigned char *snapshot_map(const char *path, unsigned long long int *length)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER file_size;
+    const void *view = NULL;
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) { return NULL; }
+
+    if (GetFileSizeEx(file, &file_size) == 0 || file_size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return NULL;
+    }
+
+    // The view keeps the mapping alive, so both handles can be closed right away.
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping != NULL) { view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0); }
+    if (mapping != NULL) { CloseHandle(mapping); }
+    CloseHandle(file);
+
+    *length = (unsigned long long int)file_size.QuadPart;
+    return view;
+#else
+    struct stat file_stat;
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) { return NULL; }
+
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    // The mapping stays valid once the descriptor is closed.
+    void *view = mmap(NULL, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) { return NULL; }
+
+    *length = (unsigned long long int)file_stat.st_size;
+    return view;
+#endif
+}
+
+// Static function that releases a mapping created by snapshot_map.
+static void snapshot_unmap(const unsigned char *data, const unsigned long long int length)
+{
+#if defined(_WIN32)
+    (void)length;
+    UnmapViewOfFile(data);
+#else
+    munmap((void *)data, (size_t)length);
+#endif
+}
+
+// Static function that writes the given words to the file, returning one on success.
+static int snapshot_write_words(FILE *file, const unsigned long long int *words, const unsigned long long int count)
+{
+    return (fwrite(words, sizeof(unsigned long long int), count, file) == count ? 1 : 0);
+}
+
+
+int mads_hash_table_snapshot_write(const mads_hash_table_t *t,
+    const char *path,
+    const mads_hash_table_blob_size_fn key_size,
+    const mads_hash_table_blob_size_fn value_size)
+{
+    mads_hash_table_iter_t it;
+    const mads_pair_t *pair = NULL;
+    unsigned long long int header[SNAPSHOT_HEADER_WORDS];
+    unsigned long long int buckets = 1;
+    assert(t != NULL && path != NULL && key_size != NULL && value_size != NULL);
+
+    // The snapshot gets a hashing function of its own, whose seeds are stored in the file.
+    mads_uni_hash_t *h = mads_uni_hash_create_pow2(MADS_HASH_TABLE_HASH_RANGE, 1);
+    while (buckets < t->n) { buckets = buckets << 1; }
+
+    unsigned long long int *offsets = (unsigned long long int *)calloc(buckets + 1, sizeof(unsigned long long int));
+    unsigned long long int *codes = (unsigned long long int *)malloc((t->n + 1) * sizeof(unsigned long long int));
+    assert(offsets != NULL && codes != NULL);
+
+    // The first pass hashes every key and adds the length of its entry to its bucket, so
+    // that after a prefix sum every bucket knows where its entries start.
+    unsigned long long int i = 0;
+    mads_hash_table_iter_init(&it, t);
+
+    while ((pair = mads_hash_table_iter_next(&it)) != NULL)
+    {
+        const void *key = mads_cue_get(mads_pair_get_cue(pair));
+        const unsigned long long int key_length = key_size(key);
+        codes[i] = mads_hash_bytes(h, key, key_length);
+        offsets[(codes[i] & (buckets - 1)) + 1] += snapshot_entry_length(key_length, value_size(mads_value_get(mads_pair_get_value(pair))));
+        i++;
+    }
+
+    for (unsigned long long int b = 0; b < buckets; b++)
+    {
+        offsets[b + 1] = offsets[b + 1] + offsets[b];
+    }
+
+    // The second pass copies every pair to the next free entry of its bucket. The table is
+    // not modified in between, so the iterator visits the pairs in the same order.
+    unsigned long long int *cursors = (unsigned long long int *)malloc(buckets * sizeof(unsigned long long int));
+    unsigned char *entries = (unsigned char *)calloc(offsets[buckets] + 1, 1);
+    assert(cursors != NULL && entries != NULL);
+    memcpy(cursors, offsets, buckets * sizeof(unsigned long long int));
+
+    i = 0;
+    mads_hash_table_iter_init(&it, t);
+
+    while ((pair = mads_hash_table_iter_next(&it)) != NULL)
+    {
+        const void *key = mads_cue_get(mads_pair_get_cue(pair));
+        const void *value = mads_value_get(mads_pair_get_value(pair));
+        const unsigned long long int words[SNAPSHOT_ENTRY_WORDS] = { codes[i], key_size(key), value_size(value) };
+        unsigned char *entry = entries + cursors[codes[i] & (buckets - 1)];
+
+        memcpy(entry, words, sizeof(words));
+        if (words[1] > 0) { memcpy(entry + sizeof(words), key, words[1]); }
+        if (words[2] > 0) { memcpy(entry + sizeof(words) + words[1], value, words[2]); }
+        cursors[codes[i] & (buckets - 1)] += snapshot_entry_length(words[1], words[2]);
+        i++;
+    }
+
+    memcpy(&header[0], MADS_HASH_TABLE_SNAPSHOT_MAGIC, 8);
+    header[1] = t->n;
+    header[2] = buckets;
+    memcpy(&header[3], h->seeds, sizeof(h->seeds));
+
+    int written = 0;
+    FILE *file = fopen(path, "wb");
+
+    if (file != NULL)
+    {
+        written = snapshot_write_words(file, header, SNAPSHOT_HEADER_WORDS)
+            && snapshot_write_words(file, offsets, buckets + 1)
+            && fwrite(entries, 1, offsets[buckets], file) == offsets[buckets];
+        written = (fclose(file) == 0 ? written : 0);
+    }
+
+    free(entries);
+    free(cursors);
+    free(codes);
+    free(offsets);
+    mads_uni_hash_free(&h);
+    return written;
+}
+
+
+mads_hash_table_snapshot_t *mads_hash_table_snapshot_load(const char *path)
+{
+    mads_hash_table_snapshot_t *new_snapshot = NULL;
+    unsigned long long int length = 0;
+    unsigned long long int header[SNAPSHOT_HEADER_WORDS];
+    assert(path != NULL);
+
+    const unsigned char *data = snapshot_map(path, &length);
+    if (data == NULL) { return NULL; }
+
+    // Only the header and the end offset are checked, so loading stays independent of the
+    // number of pairs. Lookups check the bounds of every bucket they walk.
+    const unsigned long long int header_length = sizeof(header);
+    if (length >= header_length) { memcpy(header, data, header_length); }
+
+    if (length < header_length
+        || memcmp(header, MADS_HASH_TABLE_SNAPSHOT_MAGIC, 8) != 0
+        || header[2] == 0
+        || (header[2] & (header[2] - 1)) != 0
+        || header[2] >= (length - header_length) / sizeof(unsigned long long int))
+    {
+        snapshot_unmap(data, length);
+        return NULL;
+    }
+
+    const unsigned long long int *offsets = (const unsigned long long int *)(data + header_length);
+    const unsigned long long int entries_start = header_length + (header[2] + 1) * sizeof(unsigned long long int);
+
+    if (offsets[header[2]] != length - entries_start)
+    {
+        snapshot_unmap(data, length);
+        return NULL;
+    }
+
+    new_snapshot = (mads_hash_table_snapshot_t *)malloc(sizeof(*new_snapshot));
+    assert(new_snapshot != NULL);
+
+    new_snapshot->data = data;
+    new_snapshot->length = length;
+    new_snapshot->n = header[1];
+    new_snapshot->buckets = header[2];
+    new_snapshot->offsets = offsets;
+    new_snapshot->entries = data + entries_start;
+    new_snapshot->entries_length = length - entries_start;
+
+    // Only the seeds and the table size are used by mads_hash_bytes.
+    new_snapshot->hfunc.kvalue = 0;
+    new_snapshot->hfunc.values = NULL;
+    new_snapshot->hfunc.tabsize = MADS_HASH_TABLE_HASH_RANGE;
+    memcpy(new_snapshot->hfunc.seeds, &header[3], sizeof(new_snapshot->hfunc.seeds));
+    return new_snapshot;
+}
+
+
+const void *mads_hash_table_snapshot_find(const mads_hash_table_snapshot_t *s,
+    const void *key,
+    const unsigned long long int key_length,
+    unsigned long long int *value_length)
+{
+    assert(s != NULL && (key != NULL || key_length == 0));
+    const unsigned long long int code = mads_hash_bytes(&s->hfunc, key, key_length);
+    const unsigned long long int bucket = code & (s->buckets - 1);
+    unsigned long long int position = s->offsets[bucket];
+    const unsigned long long int end = s->offsets[bucket + 1];
+    if (end > s->entries_length || position > end) { return NULL; }
+
+    while (end - position >= SNAPSHOT_ENTRY_WORDS * 8)
+    {
+        const unsigned char *entry = s->entries + position;
+        const unsigned long long int *words = (const unsigned long long int *)entry;
+        if (words[1] > end - position || words[2] > end - position) { return NULL; }
+        const unsigned long long int entry_length = snapshot_entry_length(words[1], words[2]);
+        if (entry_length > end - position) { return NULL; }
+
+        // The stored hash rules out nearly every other key before the bytes are compared.
+        if (words[0] == code
+            && words[1] == key_length
+            && (key_length == 0 || memcmp(entry + SNAPSHOT_ENTRY_WORDS * 8, key, key_length) == 0))
+        {
+            if (value_length != NULL) { *value_length = words[2]; }
+            return entry + SNAPSHOT_ENTRY_WORDS * 8 + key_length;
+        }
+
+        position = position + entry_length;
+    }
+
+    return NULL;
+}
+
+
+void mads_hash_table_snapshot_free(mads_hash_table_snapshot_t **s)
+{
+    assert(s != NULL && *s != NULL);
+    snapshot_unmap((*s)->data, (*s)->length);
+    (*s)->data = NULL;
+    free(*s);
+    *s = NULL;
+}
@@ -177,6 +177,35 @@ void mads_list_insert_at(mads_list_t *list, void *data, const unsigned long long
 }
 
 
+// The function `mads_list_insert_after` inserts a node after one the caller already holds, e.g. one
+// found while traversing the list, so the list does not have to be walked again to reach it.
+void mads_list_insert_after(mads_list_t *list, mads_llnode_t *node, void *data)
+{
+    // Initialize a new node
+    mads_llnode_t *new_node = NULL;
+
+    // Confirm the provided list and node are not NULL
+    assert(list!=NULL && node!=NULL);
+
+    // Allocate memory for the new node and assert that the allocation was successful
+    new_node = (mads_llnode_t *)malloc(sizeof(*new_node));
+    assert(new_node!=NULL);
+
+    // Link the new node between the given node and the node that follows it
+    new_node->data = data;
+    new_node->previous = node;
+    new_node->next = node->next;
+
+    // Link the next node (or the foot) back to the new node
+    if (node->next != NULL) { node->next->previous = new_node; }
+    else { list->foot = new_node; }
+
+    // Link the given node to the new node and increment the size of the list
+    node->next = new_node;
+    list->size++;
+}
+
+
 // This function retrieves the data stored at a particular position in the given list.
 // The list and the position are passed as parameters.
 // The function returns a pointer to the data found at the specified position.
@@ -417,6 +446,37 @@ void mads_list_remove_at(mads_list_t *list, const unsigned long long int positio
 }
 
 
+// The function `mads_list_remove_node` removes a node the caller already holds, e.g. one found
+// while traversing the list, so the list does not have to be walked again to locate it.
+void mads_list_remove_node(mads_list_t *list, mads_llnode_t *node)
+{
+    // Confirm the provided list and node are not NULL
+    assert(list!=NULL && node!=NULL);
+
+    // Link the previous node (or the head) to the node that follows the removed one
+    if (node->previous != NULL) { node->previous->next = node->next; }
+    else { list->head = node->next; }
+
+    // Link the next node (or the foot) to the node that precedes the removed one
+    if (node->next != NULL) { node->next->previous = node->previous; }
+    else { list->foot = node->previous; }
+
+    // Disconnect the removed node from the list
+    node->previous = node->next = NULL;
+
+    // If a destroy function was provided, use it to properly free the data held by the node
+    if (list->destroy != NULL)
+    {
+        list->destroy(node->data);
+        node->data = NULL;
+    }
+
+    // Free the memory held by the node and decrement the list size
+    free(node);
+    list->size--;
+}
+
+
 // The below function, `mads_list_print`, is used to print the elements of the `mads_list_t`
 // `list` is the list whose element we want to print
 void mads_list_print(const mads_list_t *list)
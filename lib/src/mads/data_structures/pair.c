@@ -186,6 +186,7 @@ mads_pair_t *mads_pair_create(mads_cue_t *k, mads_value_t *v)
     // Point to the key and value
     new_pair->k = k;
     new_pair->v = v;
+    new_pair->hash = 0;
 
     // Return the new key-value pair
     return new_pair;
@@ -0,0 +1,262 @@
+// ReSharper disable CppDFANullDereference
+// ReSharper disable CppDFAMemoryLeak
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <mads/data_structures/static_map.h>
+
+
+// The hashes of one key, computed once per build attempt.
+typedef struct
+{
+    unsigned long long int bucket;
+    unsigned long long int f1;
+    unsigned long long int f2;
+} static_map_key_t;
+
+
+// Static function that computes the slot of a key with the given base and step under the
+// displacement (d0, d1). Both hashes are below n, so the sum cannot overflow.
+static unsigned long long int static_map_slot(const unsigned long long int f1,
+    const unsigned long long int f2,
+    const unsigned long long int d0,
+    const unsigned long long int d1,
+    const unsigned long long int n)
+{
+    return (f1 + (d0 * f2) % n + d1) % n;
+}
+
+// Static function that searches a displacement for a bucket of several keys, given as indices
+// into the key hashes. Every candidate slot must be free and distinct from the slots of the
+// other keys of the bucket. On success the slots are taken and one is returned.
+static int static_map_place_bucket(const static_map_key_t *hashes,
+    const unsigned long long int *members,
+    const unsigned long long int size,
+    const unsigned long long int n,
+    unsigned char *taken,
+    unsigned long long int *positions,
+    unsigned long long int *displacement)
+{
+    for (unsigned long long int d0 = 0; d0 < MADS_STATIC_MAP_MAX_D0; d0++)
+    {
+        for (unsigned long long int d1 = 0; d1 < n; d1++)
+        {
+            unsigned long long int placed = 0;
+
+            while (placed < size)
+            {
+                const static_map_key_t *h = &hashes[members[placed]];
+                const unsigned long long int position = static_map_slot(h->f1, h->f2, d0, d1, n);
+                if (taken[position] != 0) { break; }
+
+                // Taken tentatively, so two keys of the bucket cannot share a slot.
+                taken[position] = 1;
+                positions[placed] = position;
+                placed++;
+            }
+
+            if (placed == size)
+            {
+                *displacement = d0 * n + d1;
+                return 1;
+            }
+
+            for (unsigned long long int i = 0; i < placed; i++) { taken[positions[i]] = 0; }
+        }
+    }
+
+    return 0;
+}
+
+// Static function that tries to build the perfect hash with freshly drawn hashes. It returns
+// one when every key got a slot of its own, or zero when the hashes must be redrawn.
+static int static_map_try_build(mads_static_map_t *m, mads_pair_t **pairs)
+{
+    const unsigned long long int n = m->n;
+    int built = 1;
+
+    static_map_key_t *hashes = (static_map_key_t *)malloc(n * sizeof(static_map_key_t));
+    unsigned long long int *starts = (unsigned long long int *)calloc(m->buckets + 1, sizeof(unsigned long long int));
+    unsigned long long int *members = (unsigned long long int *)malloc(n * sizeof(unsigned long long int));
+    unsigned long long int *order = (unsigned long long int *)malloc(m->buckets * sizeof(unsigned long long int));
+    unsigned long long int *positions = (unsigned long long int *)malloc(n * sizeof(unsigned long long int));
+    unsigned long long int *by_size = NULL;
+    unsigned char *taken = (unsigned char *)calloc(n, sizeof(unsigned char));
+    assert(hashes != NULL && starts != NULL && members != NULL && order != NULL && positions != NULL && taken != NULL);
+    memset(m->displacements, 0, m->buckets * sizeof(unsigned long long int));
+
+    // Hash every key once and group the keys by bucket with a counting sort.
+    for (unsigned long long int i = 0; i < n; i++)
+    {
+        const void *key = mads_cue_get(mads_pair_get_cue(pairs[i]));
+        hashes[i].bucket = m->hash(m->h0, key);
+        hashes[i].f1 = m->hash(m->h1, key);
+        hashes[i].f2 = m->hash(m->h2, key);
+        starts[hashes[i].bucket + 1]++;
+    }
+
+    unsigned long long int largest = 0;
+
+    for (unsigned long long int b = 0; b < m->buckets; b++)
+    {
+        if (starts[b + 1] > largest) { largest = starts[b + 1]; }
+        starts[b + 1] = starts[b + 1] + starts[b];
+    }
+
+    memcpy(positions, starts, m->buckets * sizeof(unsigned long long int));
+    for (unsigned long long int i = 0; i < n; i++) { members[positions[hashes[i].bucket]++] = i; }
+
+    // Order the buckets from the largest to the smallest, again with a counting sort, so the
+    // hardest buckets are placed while the slots are still mostly free.
+    by_size = (unsigned long long int *)calloc(largest + 2, sizeof(unsigned long long int));
+    assert(by_size != NULL);
+
+    for (unsigned long long int b = 0; b < m->buckets; b++) { by_size[largest - (starts[b + 1] - starts[b]) + 1]++; }
+    for (unsigned long long int s = 0; s <= largest; s++) { by_size[s + 1] = by_size[s + 1] + by_size[s]; }
+    for (unsigned long long int b = 0; b < m->buckets; b++) { order[by_size[largest - (starts[b + 1] - starts[b])]++] = b; }
+
+    unsigned long long int next_free = 0;
+
+    for (unsigned long long int k = 0; k < m->buckets && built == 1; k++)
+    {
+        const unsigned long long int b = order[k];
+        const unsigned long long int size = starts[b + 1] - starts[b];
+
+        // The buckets are ordered by size, so only empty buckets remain.
+        if (size == 0) { break; }
+
+        if (size == 1)
+        {
+            // A single key can go to any free slot: d0 is zero and d1 moves it there.
+            const static_map_key_t *h = &hashes[members[starts[b]]];
+            while (taken[next_free] != 0) { next_free++; }
+            taken[next_free] = 1;
+            positions[starts[b]] = next_free;
+            m->displacements[b] = (next_free + n - h->f1) % n;
+            continue;
+        }
+
+        built = static_map_place_bucket(hashes, &members[starts[b]], size, n, taken, &positions[starts[b]], &m->displacements[b]);
+    }
+
+    for (unsigned long long int i = 0; i < n && built == 1; i++)
+    {
+        m->slots[positions[i]] = pairs[members[i]];
+    }
+
+    free(by_size);
+    free(taken);
+    free(positions);
+    free(order);
+    free(members);
+    free(starts);
+    free(hashes);
+    return built;
+}
+
+
+mads_static_map_t *mads_static_map_build(const mads_hash_table_t *t)
+{
+    mads_static_map_t *new_map = NULL;
+    mads_hash_table_iter_t it;
+    mads_pair_t *pair = NULL;
+    assert(t != NULL);
+
+    mads_pair_t **pairs = (mads_pair_t **)malloc((t->n + 1) * sizeof(mads_pair_t *));
+    assert(pairs != NULL);
+
+    // Equal keys hash alike and no displacement could separate them, so a multimap only
+    // contributes the first pair of every key, the one its lookups return.
+    unsigned long long int i = 0;
+    mads_hash_table_iter_init(&it, t);
+
+    while ((pair = mads_hash_table_iter_next(&it)) != NULL)
+    {
+        if (t->options.multimap != 0 && mads_hash_table_find(t, mads_cue_get(mads_pair_get_cue(pair))) != pair) { continue; }
+        pairs[i++] = pair;
+    }
+
+    new_map = (mads_static_map_t *)malloc(sizeof(*new_map));
+    assert(new_map != NULL);
+
+    new_map->n = i;
+    new_map->buckets = i / MADS_STATIC_MAP_BUCKET_SIZE + 1;
+    new_map->hash = t->hash;
+    new_map->slots = (mads_pair_t **)calloc(new_map->n + 1, sizeof(mads_pair_t *));
+    new_map->displacements = (unsigned long long int *)calloc(new_map->buckets, sizeof(unsigned long long int));
+    new_map->h0 = NULL;
+    new_map->h1 = NULL;
+    new_map->h2 = NULL;
+    assert(new_map->slots != NULL && new_map->displacements != NULL);
+
+    int built = 0;
+
+    for (int attempt = 0; attempt < MADS_STATIC_MAP_MAX_ATTEMPTS && built == 0; attempt++)
+    {
+        if (new_map->h0 != NULL)
+        {
+            mads_uni_hash_free(&new_map->h0);
+            mads_uni_hash_free(&new_map->h1);
+            mads_uni_hash_free(&new_map->h2);
+        }
+
+        // An empty map still gets valid hashes, so a lookup never divides by zero.
+        new_map->h0 = mads_uni_hash_create(new_map->buckets, 20);
+        new_map->h1 = mads_uni_hash_create((new_map->n > 0 ? new_map->n : 1), 20);
+        new_map->h2 = mads_uni_hash_create((new_map->n > 0 ? new_map->n : 1), 20);
+        built = (new_map->n == 0 ? 1 : static_map_try_build(new_map, pairs));
+    }
+
+    assert(built == 1);
+    free(pairs);
+    return new_map;
+}
+
+
+mads_pair_t *mads_static_map_find(const mads_static_map_t *m, const void *key)
+{
+    assert(m != NULL);
+    if (m->n == 0) { return NULL; }
+
+    const unsigned long long int displacement = m->displacements[m->hash(m->h0, key)];
+    const unsigned long long int f1 = m->hash(m->h1, key);
+    const unsigned long long int f2 = m->hash(m->h2, key);
+    mads_pair_t *pair = m->slots[static_map_slot(f1, f2, displacement / m->n, displacement % m->n, m->n)];
+
+    // Keys outside the map land on some slot too, so the one probe still compares the key.
+    const mads_cue_t *cue = pair->k;
+    return (cue->comparator(cue->cue, key) == 0 ? pair : NULL);
+}
+
+
+int mads_static_map_lookup(const mads_static_map_t *m, const void *key)
+{
+    return (mads_static_map_find(m, key) != NULL ? 1 : 0);
+}
+
+
+void *mads_static_map_get_value(const mads_static_map_t *m, const void *key)
+{
+    const mads_pair_t *pair = mads_static_map_find(m, key);
+    if (pair == NULL) { return NULL; }
+    return mads_value_get(mads_pair_get_value(pair));
+}
+
+
+void mads_static_map_free(mads_static_map_t **m)
+{
+    assert(m != NULL && *m != NULL);
+    free((*m)->slots);
+    (*m)->slots = NULL;
+    free((*m)->displacements);
+    (*m)->displacements = NULL;
+    mads_uni_hash_free(&(*m)->h0);
+    mads_uni_hash_free(&(*m)->h1);
+    mads_uni_hash_free(&(*m)->h2);
+    free(*m);
+    *m = NULL;
+}
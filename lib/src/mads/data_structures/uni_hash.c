@@ -67,6 +67,45 @@ mads_uni_hash_t *mads_uni_hash_create(const unsigned long long int ts, const uns
         h->values[i] = uni_hash_next_prime(ts + mads_genrand64_int64() % ts);
     }
 
+    // Draw the seeds used by the provided hash functions
+    for (unsigned long long int i = 0; i < MADS_UNI_HASH_SEEDS; i++)
+    {
+        h->seeds[i] = mads_genrand64_int64() | 1ULL;
+    }
+
+    return h; // Return the newly created hash structure
+}
+
+// Creates a new uniform hash for a power of two table size with the given k value
+mads_uni_hash_t *mads_uni_hash_create_pow2(const unsigned long long int ts, const unsigned long long int k)
+{
+    mads_uni_hash_t *h = NULL;
+    assert(ts != 0 && k != 0); // Ensure both ts and k are not zero
+    assert((ts & (ts - 1)) == 0); // Ensure ts is a power of two
+
+    h = (mads_uni_hash_t *)malloc(sizeof(mads_uni_hash_t)); // Allocate memory for the hash structure
+    assert(h != NULL); // Ensure allocation was successful
+
+    h->kvalue = k; // Set the k value
+    h->tabsize = ts; // Set the table size
+
+    // Allocate memory for the values' array
+    h->values = (unsigned long long int *)malloc(k * sizeof(unsigned long long int));
+
+    assert(h->values != NULL); // Ensure allocation was successful
+
+    // Populate the values' array with odd numbers, which are invertible modulo a power of two
+    for (unsigned long long int i = 0; i < k; i++)
+    {
+        h->values[i] = mads_genrand64_int64() | 1ULL;
+    }
+
+    // Draw the seeds used by the provided hash functions
+    for (unsigned long long int i = 0; i < MADS_UNI_HASH_SEEDS; i++)
+    {
+        h->seeds[i] = mads_genrand64_int64() | 1ULL;
+    }
+
     return h; // Return the newly created hash structure
 }
 
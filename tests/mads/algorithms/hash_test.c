@@ -0,0 +1,155 @@
+// ReSharper disable CppUnusedIncludeDirective
+// ReSharper disable CppDFANullDereference
+// ReSharper disable CppDFAMemoryLeak
+// ReSharper disable CppDeclaratorNeverUsed
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <cmocka.h>
+#include <string.h>
+
+#include <mads/algorithms/random.h>
+#include <mads/algorithms/hash.h>
+#include <mads/data_structures/hash_table.h>
+
+
+static int strings_comparator(const void *s, const void *l)
+{
+    return strcmp((const char *)s, (const char *)l);
+}
+
+static void strings_printer(const void *s)
+{
+    printf("%s", (const char *)s);
+}
+
+static void strings_destructor(void *s)
+{
+    free(s);
+}
+
+static int integers_comparator(const void *i, const void *j)
+{
+    const long long int ii = (long long int)i;
+    const long long int jj = (long long int)j;
+    return (ii > jj) - (ii < jj);
+}
+
+static void integers_printer(const void *x)
+{
+    printf("%lld", (long long int)x);
+}
+
+
+static void mads_hash_bytes_test(void **state)
+{
+    char buffer[256];
+    mads_uni_hash_t *h = mads_uni_hash_create(1009, 20);
+    mads_uni_hash_t *wide = mads_uni_hash_create_pow2(1ULL << 63, 20);
+    mads_uni_hash_t *other = mads_uni_hash_create_pow2(1ULL << 63, 20);
+    int differs = 0;
+
+    for (unsigned long long int i = 0; i < sizeof(buffer); i++)
+    {
+        buffer[i] = (char)('a' + mads_genrand64_int64() % 26);
+    }
+
+    // Every length takes a different path through the short, medium and block-wise cases.
+    for (unsigned long long int length = 0; length < sizeof(buffer); length++)
+    {
+        assert_true(mads_hash_bytes(h, buffer, length) < 1009);
+
+        const unsigned long long int hval = mads_hash_bytes(wide, buffer, length);
+        assert_int_equal(hval, mads_hash_bytes(wide, buffer, length));
+        if (hval != mads_hash_bytes(other, buffer, length)) { differs++; }
+
+        // Changing any single byte changes the hash.
+        for (unsigned long long int i = 0; i < length; i++)
+        {
+            const char saved = buffer[i];
+            buffer[i] = '#';
+            assert_int_not_equal(mads_hash_bytes(wide, buffer, length), hval);
+            buffer[i] = saved;
+        }
+    }
+
+    // Functions drawn from different universal hashes disagree on almost every input.
+    assert_true(differs > 250);
+
+    buffer[100] = '\0';
+    assert_int_equal(mads_hash_string(h, buffer), mads_hash_bytes(h, buffer, 100));
+    assert_int_equal(mads_hash_string(h, ""), mads_hash_bytes(h, "", 0));
+
+    mads_uni_hash_free(&h);
+    mads_uni_hash_free(&wide);
+    mads_uni_hash_free(&other);
+}
+
+
+static void mads_hash_integer_test(void **state)
+{
+    unsigned long long int counts[64] = { 0 };
+    mads_uni_hash_t *h = mads_uni_hash_create_pow2(64, 20);
+
+    // Sequential keys and aligned pointers spread evenly even over a power of two table.
+    for (long long int i = 0; i < 64 * 1000; i++)
+    {
+        counts[mads_hash_integer(h, (void *)(i * 16))]++;
+        assert_int_equal(mads_hash_pointer(h, (void *)(i * 16)), mads_hash_integer(h, (void *)(i * 16)));
+    }
+
+    for (int i = 0; i < 64; i++)
+    {
+        assert_in_range(counts[i], 850, 1150);
+    }
+
+    mads_uni_hash_free(&h);
+}
+
+
+static void mads_hash_table_provided_hash_test(void **state)
+{
+    char key[32];
+    mads_hash_table_t *strings = mads_hash_table_create(mads_hash_string, MADS_HASH_TABLE_CHAIN_LIST);
+    mads_hash_table_t *integers = mads_hash_table_create(mads_hash_integer, MADS_HASH_TABLE_OPEN_ROBIN_HOOD);
+
+    for (long long int i = 0; i < 1000; i++)
+    {
+        char *string_key = malloc(32);
+        assert(string_key != NULL);
+        snprintf(string_key, 32, "key-%lld", i);
+        mads_hash_table_insert(strings, mads_pair_create(
+            mads_cue_create(string_key, strings_comparator, strings_printer, strings_destructor),
+            mads_value_create((void *)i, integers_comparator, integers_printer, NULL)));
+        mads_hash_table_insert(integers, mads_pair_create(
+            mads_cue_create((void *)i, integers_comparator, integers_printer, NULL),
+            mads_value_create((void *)i, integers_comparator, integers_printer, NULL)));
+    }
+
+    for (long long int i = 0; i < 1000; i++)
+    {
+        snprintf(key, sizeof(key), "key-%lld", i);
+        assert_int_equal((long long int)mads_hash_table_get_value(strings, key), i);
+        assert_int_equal((long long int)mads_hash_table_get_value(integers, (void *)i), i);
+    }
+
+    mads_hash_table_free(&strings);
+    mads_hash_table_free(&integers);
+}
+
+
+int main(void)
+{
+    const struct CMUnitTest tests[] =
+    {
+        cmocka_unit_test(mads_hash_bytes_test),
+        cmocka_unit_test(mads_hash_integer_test),
+        cmocka_unit_test(mads_hash_table_provided_hash_test)
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
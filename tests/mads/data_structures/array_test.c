@@ -183,6 +183,136 @@ static void mads_array_operations_test(void **state)
     mads_array_free(&strings_array);
 }
 
+static void mads_array_deque_test(void **state)
+{
+    mads_array_t *integers_array = mads_array_create(integers_comparator, integers_printer, NULL);
+    long long int expected[512];
+    size_t expected_size = 0;
+    void *temp_data = NULL;
+
+    // A FIFO queue keeps wrapping around the blocks without growing them.
+    for (long long int i = 0; i < 10000; i++)
+    {
+        mads_array_append(integers_array, *(void **)&i);
+        if (i >= 8)
+        {
+            temp_data = mads_array_get_at(integers_array, 0);
+            assert_int_equal(*(long long int *)&temp_data, i - 8);
+            mads_array_remove_at(integers_array, 0);
+        }
+    }
+
+    assert_int_equal(mads_array_size(integers_array), 8);
+    assert_int_equal(integers_array->memsize, 16);
+    mads_array_clear(integers_array);
+    assert_int_equal(integers_array->head, 0);
+
+    // Random operations at both ends and in the middle match a plain array.
+    for (long long int i = 0; i < 20000; i++)
+    {
+        const unsigned long long int operation = mads_genrand64_int64() % 4;
+
+        if (operation < 2 || expected_size == 0)
+        {
+            if (expected_size == 512) { continue; }
+            const size_t index = (operation == 0 ? 0 : mads_genrand64_int64() % (expected_size + 1));
+            memmove(&expected[index + 1], &expected[index], (expected_size - index) * sizeof(long long int));
+            expected[index] = i;
+            expected_size++;
+            mads_array_insert_at(integers_array, index, *(void **)&i);
+        }
+        else
+        {
+            const size_t index = (operation == 2 ? 0 : mads_genrand64_int64() % expected_size);
+            memmove(&expected[index], &expected[index + 1], (expected_size - index - 1) * sizeof(long long int));
+            expected_size--;
+            mads_array_remove_at(integers_array, index);
+        }
+
+        assert_int_equal(mads_array_size(integers_array), expected_size);
+        if (i % 97 != 0) { continue; }
+
+        for (size_t j = 0; j < expected_size; j++)
+        {
+            temp_data = mads_array_get_at(integers_array, j);
+            assert_int_equal(*(long long int *)&temp_data, expected[j]);
+        }
+    }
+
+    // The raw blocks start with the first element, even when the elements wrapped around.
+    void **data = mads_array_data(integers_array);
+    for (size_t j = 0; j < expected_size; j++) { assert_int_equal(*(long long int *)&data[j], expected[j]); }
+
+    mads_array_free(&integers_array);
+}
+
+static void mads_array_bulk_test(void **state)
+{
+    mads_array_t *integers_array = mads_array_create(integers_comparator, integers_printer, NULL);
+    mads_array_t *strings_array = mads_array_create(strings_comparator, strings_printer, strings_destructor);
+    long long int buffer[1000];
+    void *temp_data = NULL;
+
+    for (long long int i = 0; i < 1000; i++) { buffer[i] = i; }
+
+    // A reserved array takes the whole buffer without growing again.
+    mads_array_reserve(integers_array, 1000);
+    assert_int_equal(integers_array->memsize, 1000);
+    mads_array_append_n(integers_array, (void *const *)buffer, 1000);
+    assert_int_equal(integers_array->memsize, 1000);
+    assert_int_equal(mads_array_size(integers_array), 1000);
+
+    // Remove the front half and the back quarter, leaving 500 to 749.
+    mads_array_remove_range(integers_array, 0, 500);
+    mads_array_remove_range(integers_array, 250, 250);
+    mads_array_remove_range(integers_array, 100, 0);
+    assert_int_equal(mads_array_size(integers_array), 250);
+
+    // Insert the first 500 at the front and 750 to 999 in the back, wrapping around the blocks.
+    mads_array_insert_range(integers_array, 0, (void *const *)buffer, 500);
+    mads_array_insert_range(integers_array, 750, (void *const *)&buffer[750], 250);
+    assert_int_equal(mads_array_size(integers_array), 1000);
+
+    for (size_t i = 0; i < 1000; i++)
+    {
+        temp_data = mads_array_get_at(integers_array, i);
+        assert_int_equal(*(long long int *)&temp_data, (long long int)i);
+    }
+
+    // Splice into the middle, then cut the splice out again.
+    mads_array_insert_range(integers_array, 10, (void *const *)buffer, 20);
+    temp_data = mads_array_get_at(integers_array, 29);
+    assert_int_equal(*(long long int *)&temp_data, 19);
+    temp_data = mads_array_get_at(integers_array, 30);
+    assert_int_equal(*(long long int *)&temp_data, 10);
+    mads_array_remove_range(integers_array, 10, 20);
+
+    mads_array_remove_range(integers_array, 100, 800);
+    mads_array_shrink_to_fit(integers_array);
+    assert_int_equal(integers_array->memsize, 200);
+
+    void **data = mads_array_data(integers_array);
+    for (size_t i = 0; i < 200; i++) { assert_int_equal(*(long long int *)&data[i], (long long int)(i < 100 ? i : i + 800)); }
+
+    mads_array_clear(integers_array);
+    mads_array_shrink_to_fit(integers_array);
+    assert_int_equal(integers_array->memsize, 1);
+    mads_array_append_n(integers_array, (void *const *)buffer, 3);
+    assert_int_equal(mads_array_size(integers_array), 3);
+
+    // The destructor runs on every removed string.
+    char *strings[100];
+    for (size_t i = 0; i < 100; i++) { strings[i] = generate_random_string(); }
+    mads_array_append_n(strings_array, (void *const *)strings, 100);
+    mads_array_remove_range(strings_array, 20, 60);
+    assert_int_equal(mads_array_size(strings_array), 40);
+    assert_ptr_equal(mads_array_get_at(strings_array, 19), strings[19]);
+    assert_ptr_equal(mads_array_get_at(strings_array, 20), strings[80]);
+
+    mads_array_free(&integers_array);
+    mads_array_free(&strings_array);
+}
+
 
 int main(void)
 {
@@ -190,7 +320,9 @@ int main(void)
     {
         cmocka_unit_test(mads_array_create_test),
         cmocka_unit_test(mads_array_free_test),
-        cmocka_unit_test(mads_array_operations_test)
+        cmocka_unit_test(mads_array_operations_test),
+        cmocka_unit_test(mads_array_deque_test),
+        cmocka_unit_test(mads_array_bulk_test)
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -0,0 +1,184 @@
+// ReSharper disable CppDFAMemoryLeak
+// ReSharper disable CppDFANullDereference
+// ReSharper disable CppRedundantCastExpression
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ReSharper disable CppDeclaratorNeverUsed
+// ReSharper disable CppUnusedIncludeDirective
+
+// ReSharper disable CppParameterNeverUsed
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <cmocka.h>
+#include <string.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <threads.h>
+
+#include <mads/data_structures/atomic_map.h>
+
+#include "map_test_fixtures.h"
+
+
+static mads_pair_t *create_string_integer_pair_with_value(const long long int number, const long long int value)
+{
+    mads_pair_t *pair = create_string_integer_pair(number);
+    mads_pair_change_value(pair, mads_value_create((void *)value, integers_comparator, integers_printer, NULL));
+    return pair;
+}
+
+
+static void mads_atomic_map_create_test(void **state)
+{
+    mads_atomic_map_t *atomic_map = NULL;
+    atomic_map = mads_atomic_map_create(hash_string, 1024);
+
+    assert_non_null(atomic_map);
+    assert_non_null(atomic_map->buckets);
+    assert_int_equal(atomic_map->size, 1024);
+    assert_int_equal(atomic_map->lock_count, MADS_ATOMIC_MAP_LOCK_STRIPES);
+    assert_int_equal(atomic_map->n, 0);
+    assert_int_equal(atomic_map->epoch, 0);
+    assert_null(atomic_map->retired);
+    assert_ptr_equal(atomic_map->hash, hash_string);
+
+    mads_atomic_map_free(&atomic_map);
+    assert_null(atomic_map);
+}
+
+
+static void mads_atomic_map_operations_test(void **state)
+{
+    char key[32];
+    const long long int elements = 1000;
+    mads_pair_t *duplicate_pair = NULL;
+    mads_atomic_map_t *atomic_map = NULL;
+    atomic_map = mads_atomic_map_create(hash_string, 512);
+
+    for (long long int i = 0; i < elements; i++)
+    {
+        assert_int_equal(mads_atomic_map_insert(atomic_map, create_string_integer_pair(i)), 1);
+    }
+
+    duplicate_pair = create_string_integer_pair(0);
+    assert_int_equal(mads_atomic_map_insert(atomic_map, duplicate_pair), 0);
+    mads_pair_free(&duplicate_pair);
+    assert_int_equal(atomic_map->n, elements);
+
+    for (long long int i = 0; i < elements; i++)
+    {
+        snprintf(key, sizeof(key), "key-%lld", i);
+        assert_int_equal(mads_atomic_map_lookup(atomic_map, key), 1);
+        assert_int_equal((long long int)mads_atomic_map_get_value(atomic_map, key), i);
+
+        mads_atomic_map_replace(atomic_map, create_string_integer_pair_with_value(i, -i));
+        assert_int_equal((long long int)mads_atomic_map_get_value(atomic_map, key), -i);
+
+        if (i % 2 == 0)
+        {
+            mads_atomic_map_remove(atomic_map, key);
+            assert_int_equal(mads_atomic_map_lookup(atomic_map, key), 0);
+            assert_null(mads_atomic_map_get_value(atomic_map, key));
+        }
+    }
+
+    assert_int_equal(atomic_map->n, elements / 2);
+
+    // Without readers the epoch advances twice per retirement, freeing the retired node at once.
+    assert_null(atomic_map->retired);
+    mads_atomic_map_free(&atomic_map);
+}
+
+
+// Arguments of a stress thread.
+typedef struct
+{
+    mads_atomic_map_t *atomic_map;
+    long long int keys;
+    long long int rounds;
+    int writer;
+    int failures;
+} atomic_map_worker_t;
+
+static int atomic_map_worker(void *arg)
+{
+    char key[32];
+    atomic_map_worker_t *worker = arg;
+
+    for (long long int round = 0; round < worker->rounds; round++)
+    {
+        for (long long int i = 0; i < worker->keys; i++)
+        {
+            if (worker->writer == 1)
+            {
+                if ((round + i) % 5 == 0)
+                {
+                    snprintf(key, sizeof(key), "key-%lld", i);
+                    mads_atomic_map_remove(worker->atomic_map, key);
+                }
+                else
+                {
+                    mads_atomic_map_replace(worker->atomic_map, create_string_integer_pair_with_value(i, round * worker->keys + i));
+                }
+            }
+            else
+            {
+                // A reader sees either no pair or a pair written for this very key.
+                snprintf(key, sizeof(key), "key-%lld", i);
+                const long long int value = (long long int)mads_atomic_map_get_value(worker->atomic_map, key);
+                if (value != 0 && value % worker->keys != i) { worker->failures++; }
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+static void mads_atomic_map_stress_test(void **state)
+{
+    thrd_t threads[6];
+    atomic_map_worker_t workers[6];
+    mads_atomic_map_t *atomic_map = NULL;
+    atomic_map = mads_atomic_map_create(hash_string, 64);
+
+    for (int i = 0; i < 6; i++)
+    {
+        workers[i].atomic_map = atomic_map;
+        workers[i].keys = 256;
+        workers[i].rounds = 200;
+        workers[i].writer = (i < 2 ? 1 : 0);
+        workers[i].failures = 0;
+        assert_int_equal(thrd_create(&threads[i], atomic_map_worker, &workers[i]), thrd_success);
+    }
+
+    for (int i = 0; i < 6; i++)
+    {
+        thrd_join(threads[i], NULL);
+        assert_int_equal(workers[i].failures, 0);
+    }
+
+    for (int i = 0; i < MADS_ATOMIC_MAP_READER_STRIPES; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            assert_int_equal(atomic_map->readers[i].count[j], 0);
+        }
+    }
+
+    assert_true(atomic_map->n <= 256);
+    mads_atomic_map_free(&atomic_map);
+}
+
+
+int main(void)
+{
+    const struct CMUnitTest tests[] =
+    {
+        cmocka_unit_test(mads_atomic_map_create_test),
+        cmocka_unit_test(mads_atomic_map_operations_test),
+        cmocka_unit_test(mads_atomic_map_stress_test)
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
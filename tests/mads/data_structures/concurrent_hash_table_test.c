@@ -0,0 +1,150 @@
+// ReSharper disable CppDFAMemoryLeak
+// ReSharper disable CppDFANullDereference
+// ReSharper disable CppRedundantCastExpression
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ReSharper disable CppDeclaratorNeverUsed
+// ReSharper disable CppUnusedIncludeDirective
+
+// ReSharper disable CppParameterNeverUsed
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <cmocka.h>
+#include <string.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <threads.h>
+
+#include <mads/data_structures/concurrent_hash_table.h>
+
+#include "map_test_fixtures.h"
+
+
+static void mads_concurrent_hash_table_create_test(void **state)
+{
+    mads_concurrent_hash_table_t *table = NULL;
+    table = mads_concurrent_hash_table_create(hash_string, MADS_HASH_TABLE_CHAIN_LIST, 8);
+
+    assert_non_null(table);
+    assert_non_null(table->shards);
+    assert_int_equal(table->shard_count, 8);
+    assert_non_null(table->shard_hfunc);
+    assert_ptr_equal(table->hash, hash_string);
+
+    for (unsigned long long int i = 0; i < table->shard_count; i++)
+    {
+        assert_non_null(table->shards[i].table);
+        assert_int_equal(table->shards[i].table->chain_type, MADS_HASH_TABLE_CHAIN_LIST);
+    }
+
+    assert_int_equal(mads_concurrent_hash_table_size(table), 0);
+    mads_concurrent_hash_table_free(&table);
+    assert_null(table);
+}
+
+
+static void mads_concurrent_hash_table_operations_test(void **state)
+{
+    char key[32];
+    const long long int elements = 1000;
+    mads_pair_t *duplicate_pair = NULL;
+    mads_concurrent_hash_table_t *table = NULL;
+    table = mads_concurrent_hash_table_create(hash_string, MADS_HASH_TABLE_CHAIN_TREE, 4);
+
+    for (long long int i = 0; i < elements; i++)
+    {
+        assert_int_equal(mads_concurrent_hash_table_insert(table, create_string_integer_pair(i)), 1);
+    }
+
+    duplicate_pair = create_string_integer_pair(0);
+    assert_int_equal(mads_concurrent_hash_table_insert(table, duplicate_pair), 0);
+    mads_pair_free(&duplicate_pair);
+    assert_int_equal(mads_concurrent_hash_table_size(table), elements);
+
+    for (long long int i = 0; i < elements; i++)
+    {
+        snprintf(key, sizeof(key), "key-%lld", i);
+        assert_int_equal(mads_concurrent_hash_table_lookup(table, key), 1);
+        mads_concurrent_hash_table_change_value(table, key, (void *)(i + 1));
+        assert_int_equal((long long int)mads_concurrent_hash_table_get_value(table, key), i + 1);
+        if (i % 2 == 0) { mads_concurrent_hash_table_remove(table, key); }
+    }
+
+    assert_int_equal(mads_concurrent_hash_table_size(table), elements / 2);
+    mads_concurrent_hash_table_free(&table);
+}
+
+
+// Arguments of a worker thread: the table and the range of keys the thread owns.
+typedef struct
+{
+    mads_concurrent_hash_table_t *table;
+    long long int first;
+    long long int count;
+    int failures;
+} concurrent_worker_t;
+
+static int concurrent_worker(void *arg)
+{
+    char key[32];
+    concurrent_worker_t *worker = arg;
+
+    for (long long int i = worker->first; i < worker->first + worker->count; i++)
+    {
+        mads_concurrent_hash_table_insert(worker->table, create_string_integer_pair(i));
+        snprintf(key, sizeof(key), "key-%lld", i);
+        if ((long long int)mads_concurrent_hash_table_get_value(worker->table, key) != i) { worker->failures++; }
+    }
+
+    for (long long int i = worker->first; i < worker->first + worker->count; i += 3)
+    {
+        snprintf(key, sizeof(key), "key-%lld", i);
+        mads_concurrent_hash_table_remove(worker->table, key);
+        if (mads_concurrent_hash_table_lookup(worker->table, key) != 0) { worker->failures++; }
+    }
+
+    return 0;
+}
+
+
+static void mads_concurrent_hash_table_threads_test(void **state)
+{
+    thrd_t threads[4];
+    concurrent_worker_t workers[4];
+    const long long int count = 3000;
+    mads_concurrent_hash_table_t *table = NULL;
+    mads_hash_table_options_t options = mads_hash_table_default_options();
+    options.rehash_step = 8;
+    table = mads_concurrent_hash_table_create_with_options(hash_string, MADS_HASH_TABLE_CHAIN_LIST, 16, &options);
+
+    for (int i = 0; i < 4; i++)
+    {
+        workers[i].table = table;
+        workers[i].first = i * count;
+        workers[i].count = count;
+        workers[i].failures = 0;
+        assert_int_equal(thrd_create(&threads[i], concurrent_worker, &workers[i]), thrd_success);
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+        thrd_join(threads[i], NULL);
+        assert_int_equal(workers[i].failures, 0);
+    }
+
+    assert_int_equal(mads_concurrent_hash_table_size(table), 4 * (count - count / 3));
+    mads_concurrent_hash_table_free(&table);
+}
+
+
+int main(void)
+{
+    const struct CMUnitTest tests[] =
+    {
+        cmocka_unit_test(mads_concurrent_hash_table_create_test),
+        cmocka_unit_test(mads_concurrent_hash_table_operations_test),
+        cmocka_unit_test(mads_concurrent_hash_table_threads_test)
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,114 @@
+// ReSharper disable CppDFAMemoryLeak
+// ReSharper disable CppDFANullDereference
+// ReSharper disable CppRedundantCastExpression
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ReSharper disable CppDeclaratorNeverUsed
+// ReSharper disable CppUnusedIncludeDirective
+
+// ReSharper disable CppParameterNeverUsed
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <cmocka.h>
+#include <string.h>
+#include <assert.h>
+#include <stdlib.h>
+
+#include <mads/data_structures/flat_map.h>
+
+#include "map_test_fixtures.h"
+
+
+static void mads_flat_map_create_test(void **state)
+{
+    mads_flat_map_t *flat_map = NULL;
+    flat_map = mads_flat_map_create(hash_string);
+
+    assert_non_null(flat_map);
+    assert_non_null(flat_map->ctrl);
+    assert_non_null(flat_map->slots);
+    assert_int_equal(flat_map->capacity, MADS_FLAT_MAP_INITIAL_SIZE);
+    assert_int_equal(flat_map->n, 0);
+    assert_int_equal(flat_map->deleted, 0);
+    assert_non_null(flat_map->hfunc);
+    assert_ptr_equal(flat_map->hash, hash_string);
+
+    mads_flat_map_free(&flat_map);
+    assert_null(flat_map);
+}
+
+
+static void mads_flat_map_operations_test(void **state)
+{
+    char key[32];
+    const long long int elements = 2000;
+    mads_flat_map_t *flat_map = NULL;
+    flat_map = mads_flat_map_create(hash_string);
+
+    for (long long int i = 0; i < elements; i++)
+    {
+        mads_flat_map_insert(flat_map, create_string_integer_pair(i));
+    }
+
+    assert_int_equal(flat_map->n, elements);
+    assert_int_equal(flat_map->capacity % MADS_FLAT_MAP_GROUP_WIDTH, 0);
+    assert_true(flat_map->n * 8 <= flat_map->capacity * 7);
+
+    for (long long int i = 0; i < elements; i++)
+    {
+        snprintf(key, sizeof(key), "key-%lld", i);
+        assert_int_equal(mads_flat_map_lookup(flat_map, key), 1);
+        assert_int_equal((long long int)mads_flat_map_get_value(flat_map, key), i);
+    }
+
+    snprintf(key, sizeof(key), "key-%lld", elements);
+    assert_int_equal(mads_flat_map_lookup(flat_map, key), 0);
+    assert_null(mads_flat_map_get_value(flat_map, key));
+
+    snprintf(key, sizeof(key), "key-%d", 11);
+    mads_flat_map_change_value(flat_map, key, (void *)-11LL);
+    assert_int_equal((long long int)mads_flat_map_get_value(flat_map, key), -11);
+
+    for (long long int i = 0; i < elements; i += 2)
+    {
+        snprintf(key, sizeof(key), "key-%lld", i);
+        mads_flat_map_remove(flat_map, key);
+        assert_int_equal(mads_flat_map_lookup(flat_map, key), 0);
+    }
+
+    assert_int_equal(flat_map->n, elements / 2);
+
+    for (long long int i = 1; i < elements; i += 2)
+    {
+        snprintf(key, sizeof(key), "key-%lld", i);
+        assert_int_equal(mads_flat_map_lookup(flat_map, key), 1);
+    }
+
+    // Deleted slots must be reusable by later insertions.
+    for (long long int i = 0; i < elements; i += 2)
+    {
+        mads_flat_map_insert(flat_map, create_string_integer_pair(i));
+    }
+
+    assert_int_equal(flat_map->n, elements);
+
+    mads_flat_map_clear(flat_map);
+    assert_int_equal(flat_map->n, 0);
+    snprintf(key, sizeof(key), "key-%d", 1);
+    assert_int_equal(mads_flat_map_lookup(flat_map, key), 0);
+
+    mads_flat_map_free(&flat_map);
+    assert_null(flat_map);
+}
+
+
+int main(void)
+{
+    const struct CMUnitTest tests[] =
+    {
+        cmocka_unit_test(mads_flat_map_create_test),
+        cmocka_unit_test(mads_flat_map_operations_test)
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
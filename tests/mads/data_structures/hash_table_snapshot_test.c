@@ -0,0 +1,148 @@
+// ReSharper disable CppDFAMemoryLeak
+// ReSharper disable CppDFANullDereference
+// ReSharper disable CppRedundantCastExpression
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ReSharper disable CppDeclaratorNeverUsed
+// ReSharper disable CppUnusedIncludeDirective
+
+// ReSharper disable CppParameterNeverUsed
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <cmocka.h>
+#include <string.h>
+#include <assert.h>
+#include <stdlib.h>
+
+#include <mads/algorithms/hash.h>
+#include <mads/data_structures/hash_table_snapshot.h>
+
+#include "map_test_fixtures.h"
+
+
+#define SNAPSHOT_TEST_PATH "mads_hash_table_snapshot_test.bin"
+
+
+static unsigned long long int string_size(const void *s)
+{
+    return strlen(s) + 1;
+}
+
+static mads_pair_t *create_string_string_pair(const long long int number)
+{
+    char *key = NULL;
+    char *value = NULL;
+    mads_cue_t *cue = NULL;
+    mads_value_t *v = NULL;
+
+    key = (char *)malloc(sizeof(char) * 32);
+    value = (char *)malloc(sizeof(char) * 64);
+    assert(key != NULL && value != NULL);
+    snprintf(key, 32, "key-%lld", number);
+    snprintf(value, 64, "value-%lld-%.*s", number, (int)(number % 17), "abcdefghijklmnopq");
+
+    cue = mads_cue_create(key, strings_comparator, strings_printer, strings_destructor);
+    v = mads_value_create(value, strings_comparator, strings_printer, strings_destructor);
+    return mads_pair_create(cue, v);
+}
+
+
+static void mads_hash_table_snapshot_round_trip_test(void **state)
+{
+    char key[32];
+    char value[64];
+    unsigned long long int value_length = 0;
+    mads_hash_table_t *hash_table = mads_hash_table_create(mads_hash_string, MADS_HASH_TABLE_CHAIN_LIST);
+
+    for (long long int i = 0; i < 3000; i++)
+    {
+        mads_hash_table_insert(hash_table, create_string_string_pair(i));
+    }
+
+    assert_int_equal(mads_hash_table_snapshot_write(hash_table, SNAPSHOT_TEST_PATH, string_size, string_size), 1);
+    mads_hash_table_free(&hash_table);
+
+    mads_hash_table_snapshot_t *snapshot = mads_hash_table_snapshot_load(SNAPSHOT_TEST_PATH);
+    assert_non_null(snapshot);
+    assert_int_equal(snapshot->n, 3000);
+    assert_int_equal(snapshot->buckets, 4096);
+
+    for (long long int i = 0; i < 3000; i++)
+    {
+        snprintf(key, sizeof(key), "key-%lld", i);
+        snprintf(value, sizeof(value), "value-%lld-%.*s", i, (int)(i % 17), "abcdefghijklmnopq");
+        const char *found = mads_hash_table_snapshot_find(snapshot, key, strlen(key) + 1, &value_length);
+        assert_non_null(found);
+        assert_string_equal(found, value);
+        assert_int_equal(value_length, strlen(value) + 1);
+    }
+
+    // A key is only found with its exact bytes.
+    assert_null(mads_hash_table_snapshot_find(snapshot, "key-3000", 9, NULL));
+    assert_null(mads_hash_table_snapshot_find(snapshot, "key-7", 5, NULL));
+    assert_null(mads_hash_table_snapshot_find(snapshot, NULL, 0, NULL));
+
+    mads_hash_table_snapshot_free(&snapshot);
+    assert_null(snapshot);
+    remove(SNAPSHOT_TEST_PATH);
+}
+
+
+static void mads_hash_table_snapshot_empty_test(void **state)
+{
+    mads_hash_table_t *hash_table = mads_hash_table_create(mads_hash_string, MADS_HASH_TABLE_OPEN_ROBIN_HOOD);
+    assert_int_equal(mads_hash_table_snapshot_write(hash_table, SNAPSHOT_TEST_PATH, string_size, string_size), 1);
+    mads_hash_table_free(&hash_table);
+
+    mads_hash_table_snapshot_t *snapshot = mads_hash_table_snapshot_load(SNAPSHOT_TEST_PATH);
+    assert_non_null(snapshot);
+    assert_int_equal(snapshot->n, 0);
+    assert_null(mads_hash_table_snapshot_find(snapshot, "key-0", 6, NULL));
+    mads_hash_table_snapshot_free(&snapshot);
+    remove(SNAPSHOT_TEST_PATH);
+}
+
+
+static void mads_hash_table_snapshot_invalid_test(void **state)
+{
+    assert_null(mads_hash_table_snapshot_load("mads_hash_table_snapshot_missing.bin"));
+
+    // A file that does not start with the snapshot magic is rejected.
+    FILE *file = fopen(SNAPSHOT_TEST_PATH, "wb");
+    assert_non_null(file);
+    fputs("this is not a snapshot of a hash table, only some text", file);
+    fclose(file);
+    assert_null(mads_hash_table_snapshot_load(SNAPSHOT_TEST_PATH));
+
+    // So is a snapshot whose entries have been cut off.
+    mads_hash_table_t *hash_table = mads_hash_table_create(mads_hash_string, MADS_HASH_TABLE_CHAIN_TREE);
+    for (long long int i = 0; i < 100; i++) { mads_hash_table_insert(hash_table, create_string_string_pair(i)); }
+    assert_int_equal(mads_hash_table_snapshot_write(hash_table, SNAPSHOT_TEST_PATH, string_size, string_size), 1);
+    mads_hash_table_free(&hash_table);
+
+    file = fopen(SNAPSHOT_TEST_PATH, "rb");
+    assert_non_null(file);
+    char buffer[16384];
+    const size_t length = fread(buffer, 1, sizeof(buffer), file);
+    fclose(file);
+
+    file = fopen(SNAPSHOT_TEST_PATH, "wb");
+    assert_non_null(file);
+    fwrite(buffer, 1, length - 8, file);
+    fclose(file);
+    assert_null(mads_hash_table_snapshot_load(SNAPSHOT_TEST_PATH));
+    remove(SNAPSHOT_TEST_PATH);
+}
+
+
+int main(void)
+{
+    const struct CMUnitTest tests[] =
+    {
+        cmocka_unit_test(mads_hash_table_snapshot_round_trip_test),
+        cmocka_unit_test(mads_hash_table_snapshot_empty_test),
+        cmocka_unit_test(mads_hash_table_snapshot_invalid_test)
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -13,132 +13,956 @@
 #include <string.h>
 #include <assert.h>
 #include <stdlib.h>
-#include <time.h>
 
-#include <mads/algorithms/random.h>
+#include <mads/algorithms/hash.h>
+#include <mads/data_structures/list.h>
+#include <mads/data_structures/avl_tree.h>
 #include <mads/data_structures/hash_table.h>
 
+#include "map_test_fixtures.h"
 
-static char *generate_random_string(void)
+
+static void mads_hash_table_create_test(void **state)
+{
+    mads_hash_table_t *hash_table = NULL;
+    hash_table = mads_hash_table_create(hash_string, MADS_HASH_TABLE_CHAIN_LIST);
+
+    assert_non_null(hash_table);
+    assert_non_null(hash_table);
+    assert_int_equal(hash_table->chain_type, MADS_HASH_TABLE_CHAIN_LIST);
+    assert_int_equal(hash_table->size, MADS_HASH_TABLE_INITIAL_SIZE);
+    assert_int_equal(hash_table->n, 0);
+    assert_int_equal(hash_table->load_factor, 0);
+    assert_non_null(hash_table->hfunc);
+    assert_ptr_equal(hash_table->hash, hash_string);
+
+    mads_hash_table_free(&hash_table);
+}
+
+
+static void mads_hash_table_free_test(void **state)
+{
+    mads_hash_table_t *list_hash_table = NULL;
+    mads_hash_table_t *tree_hash_table = NULL;
+    list_hash_table = mads_hash_table_create(hash_string, MADS_HASH_TABLE_CHAIN_TREE);
+    tree_hash_table = mads_hash_table_create(hash_string, MADS_HASH_TABLE_CHAIN_TREE);
+
+    mads_hash_table_free(&list_hash_table);
+    mads_hash_table_free(&tree_hash_table);
+    assert_null(list_hash_table);
+    assert_null(tree_hash_table);
+}
+
+
+static void hash_table_operations(const int chain_type, const mads_hash_table_options_t *options)
 {
-    char *random_string = NULL;
-    const char characters[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
-    const size_t string_length = mads_genrand64_int64() % 10;
+    char key[32];
+    int inserted = 0;
+    const long long int elements = 1000;
+    mads_pair_t *pair = NULL;
+    mads_pair_t *duplicate_pair = NULL;
+    mads_hash_table_t *hash_table = NULL;
+    hash_table = mads_hash_table_create_with_options(hash_string, chain_type, options);
+    assert_int_equal(hash_table->chain_type, chain_type);
+
+    for (long long int i = 0; i < elements; i++)
+    {
+        mads_hash_table_insert(hash_table, create_string_integer_pair(i));
+    }
+
+    assert_int_equal(hash_table->n, elements);
+    assert_true(hash_table->size > MADS_HASH_TABLE_INITIAL_SIZE);
+    assert_true(hash_table->load_factor <= 0.85);
+
+    for (long long int i = 0; i < elements; i++)
+    {
+        snprintf(key, sizeof(key), "key-%lld", i);
+        assert_int_equal(mads_hash_table_lookup(hash_table, key), 1);
+        assert_int_equal((long long int)mads_hash_table_get_value(hash_table, key), i);
+    }
+
+    snprintf(key, sizeof(key), "key-%lld", elements);
+    assert_int_equal(mads_hash_table_lookup(hash_table, key), 0);
+    assert_null(mads_hash_table_get_value(hash_table, key));
+    assert_null(mads_hash_table_find(hash_table, key));
 
-    random_string = (char *)malloc(sizeof(char) * (string_length + 1));
-    assert(random_string != NULL);
+    snprintf(key, sizeof(key), "key-%d", 7);
+    mads_hash_table_change_value(hash_table, key, (void *)-7LL);
+    assert_int_equal((long long int)mads_hash_table_get_value(hash_table, key), -7);
 
-    for (size_t i = 0; i < string_length; i++)
+    // An existing key is returned instead of inserting the duplicate pair.
+    duplicate_pair = create_string_integer_pair(7);
+    pair = mads_hash_table_find_or_insert(hash_table, duplicate_pair, &inserted);
+    assert_int_equal(inserted, 0);
+    assert_ptr_not_equal(pair, duplicate_pair);
+    assert_ptr_equal(pair, mads_hash_table_find(hash_table, key));
+    assert_int_equal(hash_table->n, elements);
+    mads_pair_free(&duplicate_pair);
+
+    for (long long int i = 0; i < elements; i += 2)
+    {
+        snprintf(key, sizeof(key), "key-%lld", i);
+        mads_hash_table_remove(hash_table, key);
+        mads_hash_table_remove(hash_table, key);
+    }
+
+    assert_int_equal(hash_table->n, elements / 2);
+
+    for (long long int i = 1; i < elements; i += 2)
     {
-        random_string[i] = characters[mads_genrand64_int64() % (sizeof(characters) - 1)];
+        snprintf(key, sizeof(key), "key-%lld", i);
+        assert_int_equal(mads_hash_table_lookup(hash_table, key), 1);
+        snprintf(key, sizeof(key), "key-%lld", i - 1);
+        assert_int_equal(mads_hash_table_lookup(hash_table, key), 0);
     }
 
-    random_string[string_length] = '\0';
-    return random_string;
+    pair = create_string_integer_pair(0);
+    assert_ptr_equal(mads_hash_table_find_or_insert(hash_table, pair, &inserted), pair);
+    assert_int_equal(inserted, 1);
+    assert_int_equal(hash_table->n, elements / 2 + 1);
+
+    mads_hash_table_free(&hash_table);
+    assert_null(hash_table);
 }
 
-static int strings_comparator(const void *s, const void *l)
+
+static void mads_hash_table_chain_list_test(void **state)
 {
-    const char *ss = (char *)s;
-    const char *ll = (char *)l;
-    return strcmp(ss, ll);
+    hash_table_operations(MADS_HASH_TABLE_CHAIN_LIST, NULL);
 }
 
-static void strings_printer(const void *s)
+
+static void mads_hash_table_chain_tree_test(void **state)
 {
-    const char *ss = (char *)s;
-    printf("%s", ss);
+    hash_table_operations(MADS_HASH_TABLE_CHAIN_TREE, NULL);
+}
+
+
+static unsigned long long int hash_colliding(const mads_uni_hash_t *uni_hash, const void *data)
+{
+    return 42;
 }
 
-static void strings_destructor(void *s)
+
+static void mads_hash_table_chain_hybrid_test(void **state)
 {
-    char *ss = (char *)s;
-    free(ss);
-    ss = NULL;
+    char key[32];
+    mads_hash_table_iter_t it;
+    unsigned long long int visited = 0;
+    mads_hash_table_t *hash_table = NULL;
+    mads_hash_table_options_t options = mads_hash_table_default_options();
+    hash_table_operations(MADS_HASH_TABLE_CHAIN_HYBRID, NULL);
+    options.rehash_step = 4;
+    hash_table_operations(MADS_HASH_TABLE_CHAIN_HYBRID, &options);
+
+    // Every key collides, so the one bucket becomes a tree and keeps its logarithmic height.
+    hash_table = mads_hash_table_create(hash_colliding, MADS_HASH_TABLE_CHAIN_HYBRID);
+    assert_non_null(hash_table->trees);
+
+    for (long long int i = 0; i < MADS_HASH_TABLE_TREEIFY_THRESHOLD; i++)
+    {
+        mads_hash_table_insert(hash_table, create_string_integer_pair(i));
+    }
+
+    const unsigned long long int bucket = 42 % hash_table->size;
+    assert_int_equal(hash_table->trees[bucket], 0);
+
+    for (long long int i = MADS_HASH_TABLE_TREEIFY_THRESHOLD; i < 1000; i++)
+    {
+        mads_hash_table_insert(hash_table, create_string_integer_pair(i));
+    }
+
+    const unsigned long long int home = 42 % hash_table->size;
+    assert_int_equal(hash_table->trees[home], 1);
+    assert_true(mads_avl_tree_get_height(hash_table->A[home]) < 16);
+    assert_int_equal(mads_hash_table_stats(hash_table).max_chain_length, 1000);
+
+    mads_hash_table_iter_init(&it, hash_table);
+    while (mads_hash_table_iter_next(&it) != NULL) { visited++; }
+    assert_int_equal(visited, 1000);
+
+    // Removing most keys turns the bucket back into a list.
+    for (long long int i = 0; i < 997; i++)
+    {
+        snprintf(key, sizeof(key), "key-%lld", i);
+        assert_int_equal(mads_hash_table_lookup(hash_table, key), 1);
+        mads_hash_table_remove(hash_table, key);
+    }
+
+    assert_int_equal(hash_table->trees[home], 0);
+    assert_int_equal(mads_list_size(hash_table->A[home]), 3);
+    assert_int_equal((long long int)mads_hash_table_get_value(hash_table, "key-998"), 998);
+    assert_int_equal(mads_hash_table_lookup(hash_table, "key-10"), 0);
+
+    mads_hash_table_free(&hash_table);
+}
+
+
+static void mads_hash_table_robin_hood_test(void **state)
+{
+    mads_hash_table_t *hash_table = NULL;
+    hash_table = mads_hash_table_create(hash_string, MADS_HASH_TABLE_OPEN_ROBIN_HOOD);
+    assert_null(hash_table->A);
+    assert_non_null(hash_table->slots);
+    mads_hash_table_free(&hash_table);
+
+    hash_table_operations(MADS_HASH_TABLE_OPEN_ROBIN_HOOD, NULL);
+}
+
+
+static void mads_hash_table_incremental_rehash_test(void **state)
+{
+    char key[32];
+    mads_hash_table_t *hash_table = NULL;
+    mads_hash_table_options_t options = mads_hash_table_default_options();
+    assert_int_equal(options.rehash_step, 0);
+    options.rehash_step = 4;
+
+    hash_table_operations(MADS_HASH_TABLE_CHAIN_LIST, &options);
+    hash_table_operations(MADS_HASH_TABLE_CHAIN_TREE, &options);
+
+    // Every key stays reachable while the buckets are migrated a few at a time.
+    hash_table = mads_hash_table_create_with_options(hash_string, MADS_HASH_TABLE_CHAIN_LIST, &options);
+
+    for (long long int i = 0; i < 200; i++)
+    {
+        mads_hash_table_insert(hash_table, create_string_integer_pair(i));
+
+        for (long long int j = 0; j <= i; j++)
+        {
+            snprintf(key, sizeof(key), "key-%lld", j);
+            assert_int_equal((long long int)mads_hash_table_get_value(hash_table, key), j);
+        }
+    }
+
+    assert_non_null(hash_table->old_A);
+    assert_true(hash_table->migrate_pos > 0);
+    assert_int_equal(hash_table->n, 200);
+    mads_hash_table_free(&hash_table);
 }
 
-static int integers_comparator(const void *i, const void *j)
+
+static void mads_hash_table_rehash_pace_test(void **state)
 {
-    const long long int *ii = (long long int *)&i;
-    const long long int *jj = (long long int *)&j;
+    char key[32];
+    mads_hash_table_options_t options = mads_hash_table_default_options();
+    options.rehash_step = 1;
+    options.min_load_factor = 0.1;
+    mads_hash_table_t *hash_table = mads_hash_table_create_with_options(hash_string, MADS_HASH_TABLE_CHAIN_LIST, &options);
+    unsigned long long int resizes = 0;
+
+    // A step of one bucket cannot keep up with the growth on its own. The migration still ends
+    // before the next resize starts, instead of being finished at once by that resize.
+    for (long long int i = 0; i < 20000; i++)
+    {
+        const unsigned long long int size = hash_table->size;
+        const unsigned long long int pending = (hash_table->old_A != NULL ? hash_table->old_size - hash_table->migrate_pos : 0);
+        mads_hash_table_insert(hash_table, create_string_integer_pair(i));
+        if (hash_table->size == size) { continue; }
+        assert_true(pending <= 4);
+        resizes++;
+    }
+
+    assert_true(resizes >= 5);
+
+    // A shrink leaves fewer removals than old buckets, so each removal migrates a few more.
+    for (long long int i = 0; i < 20000; i++)
+    {
+        const unsigned long long int size = hash_table->size;
+        const unsigned long long int pending = (hash_table->old_A != NULL ? hash_table->old_size - hash_table->migrate_pos : 0);
+        snprintf(key, sizeof(key), "key-%lld", i);
+        mads_hash_table_remove(hash_table, key);
+        if (hash_table->size == size) { continue; }
+        assert_true(pending <= 16);
+        resizes++;
+    }
 
-    if (*ii > *jj) { return 1.0; }
-    if (*ii < *jj) { return -1.0; }
-    return 0.0;
+    assert_true(resizes >= 10);
+    assert_int_equal(hash_table->n, 0);
+    mads_hash_table_free(&hash_table);
 }
 
-static int reals_comparator(const void *x, const void *y)
+
+static void mads_hash_table_pow2_sizing_test(void **state)
 {
-    const double *xx = (double *)&x;
-    const double *yy = (double *)&y;
+    mads_hash_table_t *hash_table = NULL;
+    mads_hash_table_options_t options = mads_hash_table_default_options();
+    assert_int_equal(options.sizing, MADS_HASH_TABLE_SIZING_PRIME);
+    options.sizing = MADS_HASH_TABLE_SIZING_POW2;
 
-    if (*xx > *yy) { return 1.0; }
-    if (*xx < *yy) { return -1.0; }
-    return 0.0;
+    hash_table = mads_hash_table_create_with_options(hash_string, MADS_HASH_TABLE_CHAIN_LIST, &options);
+    assert_int_equal(hash_table->size, 128);
+    assert_int_equal(mads_uni_hash_get_table_size(hash_table->hfunc), MADS_HASH_TABLE_HASH_RANGE);
+    mads_hash_table_free(&hash_table);
+
+    hash_table_operations(MADS_HASH_TABLE_CHAIN_LIST, &options);
+    hash_table_operations(MADS_HASH_TABLE_CHAIN_TREE, &options);
+    hash_table_operations(MADS_HASH_TABLE_OPEN_ROBIN_HOOD, &options);
+
+    options.rehash_step = 4;
+    hash_table_operations(MADS_HASH_TABLE_CHAIN_LIST, &options);
 }
 
-static void reals_printer(const void *x)
+
+static void mads_hash_table_capacity_test(void **state)
 {
-    const double *xx = (double *)&x;
-    printf("%lf", *xx);
+    char key[32];
+    unsigned long long int size;
+    const long long int elements = 1000;
+    mads_hash_table_t *hash_table = NULL;
+
+    hash_table = mads_hash_table_create_with_capacity(hash_string, MADS_HASH_TABLE_CHAIN_LIST, elements, NULL);
+    size = hash_table->size;
+    assert_true(size * MADS_HASH_TABLE_MAX_LOAD_FACTOR >= elements);
+
+    for (long long int i = 0; i < elements; i++)
+    {
+        mads_hash_table_insert(hash_table, create_string_integer_pair(i));
+    }
+
+    assert_int_equal(hash_table->size, size);
+    mads_hash_table_reserve(hash_table, elements / 2);
+    assert_int_equal(hash_table->size, size);
+
+    // Reserving rehashes every stored pair into the larger bucket array.
+    mads_hash_table_reserve(hash_table, 4 * elements);
+    assert_true(hash_table->size * MADS_HASH_TABLE_MAX_LOAD_FACTOR >= 4 * elements);
+    assert_null(hash_table->old_A);
+    size = hash_table->size;
+
+    for (long long int i = 0; i < elements; i++)
+    {
+        snprintf(key, sizeof(key), "key-%lld", i);
+        assert_int_equal((long long int)mads_hash_table_get_value(hash_table, key), i);
+        mads_hash_table_insert(hash_table, create_string_integer_pair(elements + i));
+    }
+
+    assert_int_equal(hash_table->size, size);
+    assert_int_equal(hash_table->n, 2 * elements);
+    mads_hash_table_free(&hash_table);
+
+    // The options are kept, and their load factor sizes the bucket array.
+    mads_hash_table_options_t options = mads_hash_table_default_options();
+    options.sizing = MADS_HASH_TABLE_SIZING_POW2;
+    options.max_load_factor = 0.5;
+    options.rehash_step = 4;
+    hash_table = mads_hash_table_create_with_capacity(hash_string, MADS_HASH_TABLE_CHAIN_LIST, elements, &options);
+    assert_int_equal(hash_table->size, 2048);
+    assert_int_equal(hash_table->options.rehash_step, 4);
+
+    for (long long int i = 0; i < elements; i++)
+    {
+        mads_hash_table_insert(hash_table, create_string_integer_pair(i));
+    }
+
+    assert_int_equal(hash_table->size, 2048);
+    mads_hash_table_free(&hash_table);
 }
 
-static void integers_printer(const void *x)
+
+static void hash_table_batch_operations(const int chain_type, const mads_hash_table_options_t *options)
 {
-    const long long int *xx = (long long int *)&x;
-    printf("%lld", *xx);
+    const long long int elements = 1000;
+    mads_pair_t *pairs[1000];
+    void *keys[1001];
+    void *values[1001];
+    int inserted[1000];
+    mads_hash_table_t *hash_table = NULL;
+    hash_table = mads_hash_table_create_with_options(hash_string, chain_type, options);
+
+    for (long long int i = 0; i < elements; i++)
+    {
+        pairs[i] = create_string_integer_pair(i % 900);
+        keys[i] = mads_cue_get(mads_pair_get_cue(pairs[i]));
+    }
+
+    // The last 100 pairs repeat keys of the first ones and are not inserted.
+    mads_hash_table_insert_batch(hash_table, pairs, elements, inserted);
+    assert_int_equal(hash_table->n, 900);
+
+    for (long long int i = 0; i < elements; i++)
+    {
+        assert_int_equal(inserted[i], (i < 900 ? 1 : 0));
+    }
+
+    keys[elements] = "missing";
+    mads_hash_table_get_values_batch(hash_table, keys, elements + 1, values);
+
+    for (long long int i = 0; i < elements; i++)
+    {
+        assert_int_equal((long long int)values[i], i % 900);
+    }
+
+    assert_null(values[elements]);
+
+    for (long long int i = 900; i < elements; i++)
+    {
+        mads_pair_free(&pairs[i]);
+    }
+
+    mads_hash_table_free(&hash_table);
 }
 
-static unsigned long long int hash_string(const mads_uni_hash_t *uni_hash, const void *data)
+
+static void mads_hash_table_batch_test(void **state)
 {
-    unsigned long long int max_k;
-    unsigned long long int tab_size;
-    unsigned long long int k = 0;
-    unsigned long long int hval = 0;
-    const char *string_key = (char *)data;
+    mads_hash_table_options_t options = mads_hash_table_default_options();
+    options.rehash_step = 4;
 
-    tab_size = mads_uni_hash_get_table_size(uni_hash);
-    max_k = mads_uni_hash_get_k(uni_hash);
+    hash_table_batch_operations(MADS_HASH_TABLE_CHAIN_LIST, NULL);
+    hash_table_batch_operations(MADS_HASH_TABLE_CHAIN_TREE, NULL);
+    hash_table_batch_operations(MADS_HASH_TABLE_OPEN_ROBIN_HOOD, NULL);
+    hash_table_batch_operations(MADS_HASH_TABLE_CHAIN_LIST, &options);
 
-    for (unsigned long long int i = 0; string_key[i] != '\0'; i++)
+    // A batch group may need more room than a tiny growth factor gives a nearly full table.
+    mads_hash_table_options_t tight_options = mads_hash_table_default_options();
+    tight_options.sizing = MADS_HASH_TABLE_SIZING_PRIME;
+    tight_options.max_load_factor = 0.99;
+    tight_options.growth_factor = 1.01;
+    hash_table_batch_operations(MADS_HASH_TABLE_OPEN_ROBIN_HOOD, &tight_options);
+    hash_table_batch_operations(MADS_HASH_TABLE_CHAIN_LIST, &tight_options);
+
+    // Close to one, the load factor alone would let a Robin Hood table fill every slot.
+    tight_options.max_load_factor = 0.999;
+    hash_table_batch_operations(MADS_HASH_TABLE_OPEN_ROBIN_HOOD, &tight_options);
+    mads_hash_table_t *hash_table = mads_hash_table_create_with_options(hash_string, MADS_HASH_TABLE_OPEN_ROBIN_HOOD, &tight_options);
+
+    for (long long int i = 0; i < 2000; i++)
+    {
+        mads_hash_table_insert(hash_table, create_string_integer_pair(i));
+        assert_true(hash_table->n < hash_table->size);
+    }
+
+    for (long long int i = 0; i < 2000; i++)
     {
-        hval += string_key[i] * uni_hash->values[k];
-        k++;
-        if (k == max_k) { k = 0; }
+        char key[32];
+        snprintf(key, sizeof(key), "key-%lld", i);
+        assert_int_equal((long long int)mads_hash_table_get_value(hash_table, key), i);
     }
 
-    return hval % tab_size;
+    mads_hash_table_free(&hash_table);
+}
+
+
+static void hash_table_sum_values(mads_pair_t *pair, void *ctx)
+{
+    long long int *sum = ctx;
+    *sum += (long long int)mads_value_get(mads_pair_get_value(pair));
 }
 
-static void mads_hash_table_create_test(void **state)
+
+static void hash_table_iteration(const int chain_type, const mads_hash_table_options_t *options)
 {
+    char visited[500] = { 0 };
+    long long int sum = 0;
+    long long int count = 0;
+    mads_pair_t *pair = NULL;
+    mads_hash_table_iter_t it;
     mads_hash_table_t *hash_table = NULL;
-    hash_table = mads_hash_table_create(hash_string, MADS_HASH_TABLE_CHAIN_LIST);
+    hash_table = mads_hash_table_create_with_options(hash_string, chain_type, options);
+
+    mads_hash_table_iter_init(&it, hash_table);
+    assert_null(mads_hash_table_iter_next(&it));
+
+    for (long long int i = 0; i < 500; i++)
+    {
+        mads_hash_table_insert(hash_table, create_string_integer_pair(i));
+    }
+
+    mads_hash_table_iter_init(&it, hash_table);
+
+    while ((pair = mads_hash_table_iter_next(&it)) != NULL)
+    {
+        const long long int value = (long long int)mads_value_get(mads_pair_get_value(pair));
+        assert_in_range(value, 0, 499);
+        assert_int_equal(visited[value], 0);
+        visited[value] = 1;
+        count++;
+    }
+
+    assert_int_equal(count, 500);
+    assert_null(mads_hash_table_iter_next(&it));
+
+    mads_hash_table_for_each(hash_table, hash_table_sum_values, &sum);
+    assert_int_equal(sum, 499 * 500 / 2);
+    mads_hash_table_free(&hash_table);
+}
+
+
+static void mads_hash_table_iterator_test(void **state)
+{
+    mads_hash_table_options_t options = mads_hash_table_default_options();
+    options.rehash_step = 1;
+
+    hash_table_iteration(MADS_HASH_TABLE_CHAIN_LIST, NULL);
+    hash_table_iteration(MADS_HASH_TABLE_CHAIN_TREE, NULL);
+    hash_table_iteration(MADS_HASH_TABLE_OPEN_ROBIN_HOOD, NULL);
+
+    // Pairs still waiting in the old buckets of an in-progress resize are visited too.
+    hash_table_iteration(MADS_HASH_TABLE_CHAIN_LIST, &options);
+    hash_table_iteration(MADS_HASH_TABLE_CHAIN_TREE, &options);
+    hash_table_iteration(MADS_HASH_TABLE_CHAIN_HYBRID, &options);
+}
+
+
+static unsigned long long int hash_string_calls = 0;
+
+static unsigned long long int hash_string_counted(const mads_uni_hash_t *uni_hash, const void *data)
+{
+    hash_string_calls++;
+    return hash_string(uni_hash, data);
+}
+
+
+static void hash_table_cached_hashing(const int chain_type, const mads_hash_table_options_t *options)
+{
+    mads_hash_table_t *hash_table = NULL;
+    hash_table = mads_hash_table_create_with_options(hash_string_counted, chain_type, options);
+    hash_string_calls = 0;
+
+    // Every insertion hashes its key once, however many times the table grows meanwhile.
+    for (long long int i = 0; i < 1000; i++)
+    {
+        mads_hash_table_insert(hash_table, create_string_integer_pair(i));
+    }
+
+    assert_true(hash_table->size > MADS_HASH_TABLE_INITIAL_SIZE);
+    assert_int_equal(hash_string_calls, 1000);
+
+    for (long long int i = 0; i < 1000; i++)
+    {
+        char key[32];
+        snprintf(key, sizeof(key), "key-%lld", i);
+        assert_int_equal((long long int)mads_hash_table_get_value(hash_table, key), i);
+    }
+
+    assert_null(mads_hash_table_get_value(hash_table, "key-1000"));
+    mads_hash_table_free(&hash_table);
+}
+
+
+static void mads_hash_table_cached_hash_test(void **state)
+{
+    mads_hash_table_options_t options = mads_hash_table_default_options();
+
+    hash_table_cached_hashing(MADS_HASH_TABLE_CHAIN_LIST, &options);
+    hash_table_cached_hashing(MADS_HASH_TABLE_CHAIN_TREE, &options);
+    hash_table_cached_hashing(MADS_HASH_TABLE_OPEN_ROBIN_HOOD, &options);
+
+    options.sizing = MADS_HASH_TABLE_SIZING_POW2;
+    options.rehash_step = 2;
+    hash_table_cached_hashing(MADS_HASH_TABLE_CHAIN_LIST, &options);
+    hash_table_cached_hashing(MADS_HASH_TABLE_OPEN_ROBIN_HOOD, &options);
+}
+
+
+static void hash_table_clearing(const int chain_type, const mads_hash_table_options_t *options)
+{
+    mads_hash_table_t *hash_table = NULL;
+    hash_table = mads_hash_table_create_with_options(hash_string, chain_type, options);
+
+    for (long long int i = 0; i < 500; i++)
+    {
+        mads_hash_table_insert(hash_table, create_string_integer_pair(i));
+    }
+
+    const unsigned long long int size = hash_table->size;
+    const void *first_bucket = (hash_table->A != NULL ? hash_table->A[0] : NULL);
+    mads_hash_table_clear(hash_table);
 
-    assert_non_null(hash_table);
-    assert_non_null(hash_table);
-    assert_int_equal(hash_table->chain_type, MADS_HASH_TABLE_CHAIN_LIST);
-    assert_int_equal(hash_table->size, MADS_HASH_TABLE_INITIAL_SIZE);
     assert_int_equal(hash_table->n, 0);
-    assert_int_equal(hash_table->load_factor, 0);
-    assert_non_null(hash_table->hfunc);
-    assert_ptr_equal(hash_table->hash, hash_string);
+    assert_int_equal(hash_table->size, size);
+    assert_null(hash_table->old_A);
+    if (first_bucket != NULL) { assert_ptr_equal(hash_table->A[0], first_bucket); }
+    assert_null(mads_hash_table_get_value(hash_table, "key-7"));
+
+    for (long long int i = 0; i < 500; i++)
+    {
+        mads_hash_table_insert(hash_table, create_string_integer_pair(i));
+    }
+
+    assert_int_equal(hash_table->n, 500);
+    assert_int_equal(hash_table->size, size);
+    assert_int_equal((long long int)mads_hash_table_get_value(hash_table, "key-7"), 7);
+
+    mads_hash_table_clear_and_shrink(hash_table);
+    assert_int_equal(hash_table->n, 0);
+    assert_true(hash_table->size < size);
+    assert_null(mads_hash_table_get_value(hash_table, "key-7"));
 
+    mads_hash_table_insert(hash_table, create_string_integer_pair(7));
+    assert_int_equal((long long int)mads_hash_table_get_value(hash_table, "key-7"), 7);
     mads_hash_table_free(&hash_table);
 }
 
 
-static void mads_hash_table_free_test(void **state)
+static void mads_hash_table_clear_test(void **state)
 {
-    mads_hash_table_t *list_hash_table = NULL;
-    mads_hash_table_t *tree_hash_table = NULL;
-    list_hash_table = mads_hash_table_create(hash_string, MADS_HASH_TABLE_CHAIN_TREE);
-    tree_hash_table = mads_hash_table_create(hash_string, MADS_HASH_TABLE_CHAIN_TREE);
+    mads_hash_table_options_t options = mads_hash_table_default_options();
 
-    mads_hash_table_free(&list_hash_table);
-    mads_hash_table_free(&tree_hash_table);
-    assert_null(list_hash_table);
-    assert_null(tree_hash_table);
+    hash_table_clearing(MADS_HASH_TABLE_CHAIN_LIST, &options);
+    hash_table_clearing(MADS_HASH_TABLE_CHAIN_TREE, &options);
+    hash_table_clearing(MADS_HASH_TABLE_CHAIN_HYBRID, &options);
+    hash_table_clearing(MADS_HASH_TABLE_OPEN_ROBIN_HOOD, &options);
+
+    // Clearing in the middle of an incremental resize drops the old buckets too.
+    options.sizing = MADS_HASH_TABLE_SIZING_POW2;
+    options.rehash_step = 1;
+    hash_table_clearing(MADS_HASH_TABLE_CHAIN_LIST, &options);
+    hash_table_clearing(MADS_HASH_TABLE_CHAIN_TREE, &options);
+}
+
+
+static void hash_table_shrinking(const int chain_type, const mads_hash_table_options_t *options)
+{
+    char key[32];
+    mads_hash_table_t *hash_table = NULL;
+    hash_table = mads_hash_table_create_with_options(hash_string, chain_type, options);
+
+    for (long long int i = 0; i < 2000; i++)
+    {
+        mads_hash_table_insert(hash_table, create_string_integer_pair(i));
+    }
+
+    const unsigned long long int peak_size = hash_table->size;
+
+    for (long long int i = 50; i < 2000; i++)
+    {
+        snprintf(key, sizeof(key), "key-%lld", i);
+        mads_hash_table_remove(hash_table, key);
+    }
+
+    assert_int_equal(hash_table->n, 50);
+
+    if (options->min_load_factor > 0)
+    {
+        // The table shrank on its own, but not below the low-water mark or its initial size.
+        assert_true(hash_table->size < peak_size);
+        assert_true(hash_table->size >= MADS_HASH_TABLE_INITIAL_SIZE);
+    }
+    else
+    {
+        assert_int_equal(hash_table->size, peak_size);
+        mads_hash_table_shrink_to_fit(hash_table);
+        assert_true(hash_table->size < peak_size);
+        assert_null(hash_table->old_A);
+    }
+
+    for (long long int i = 0; i < 2000; i++)
+    {
+        snprintf(key, sizeof(key), "key-%lld", i);
+        assert_int_equal(mads_hash_table_lookup(hash_table, key), (i < 50 ? 1 : 0));
+    }
+
+    mads_hash_table_free(&hash_table);
+}
+
+
+static void mads_hash_table_shrink_test(void **state)
+{
+    mads_hash_table_options_t options = mads_hash_table_default_options();
+
+    hash_table_shrinking(MADS_HASH_TABLE_CHAIN_LIST, &options);
+    hash_table_shrinking(MADS_HASH_TABLE_CHAIN_TREE, &options);
+    hash_table_shrinking(MADS_HASH_TABLE_OPEN_ROBIN_HOOD, &options);
+
+    options.min_load_factor = 0.1;
+    hash_table_shrinking(MADS_HASH_TABLE_CHAIN_LIST, &options);
+    hash_table_shrinking(MADS_HASH_TABLE_CHAIN_TREE, &options);
+    hash_table_shrinking(MADS_HASH_TABLE_CHAIN_HYBRID, &options);
+    hash_table_shrinking(MADS_HASH_TABLE_OPEN_ROBIN_HOOD, &options);
+
+    options.sizing = MADS_HASH_TABLE_SIZING_POW2;
+    options.rehash_step = 2;
+    hash_table_shrinking(MADS_HASH_TABLE_CHAIN_LIST, &options);
+    hash_table_shrinking(MADS_HASH_TABLE_CHAIN_TREE, &options);
+}
+
+
+static void hash_table_tuning(const int chain_type, const mads_hash_table_options_t *options)
+{
+    mads_hash_table_t *hash_table = NULL;
+    mads_hash_table_stats_t stats;
+    hash_table = mads_hash_table_create_with_options(hash_string, chain_type, options);
+
+    stats = mads_hash_table_stats(hash_table);
+    assert_int_equal(stats.n, 0);
+    assert_int_equal(stats.used_buckets, 0);
+    assert_int_equal(stats.max_chain_length, 0);
+
+    for (long long int i = 0; i < 1000; i++)
+    {
+        mads_hash_table_insert(hash_table, create_string_integer_pair(i));
+        // The table grows before an insertion that starts above the maximum load factor.
+        assert_true((double)(hash_table->n - 1) <= options->max_load_factor * (double)hash_table->size);
+    }
+
+    stats = mads_hash_table_stats(hash_table);
+    assert_int_equal(stats.n, 1000);
+    assert_int_equal(stats.size, hash_table->size);
+    assert_true(stats.used_buckets > 0 && stats.used_buckets <= stats.size);
+    assert_true(stats.average_chain_length >= 1.0);
+    assert_true((double)stats.max_chain_length >= stats.average_chain_length);
+
+    // Every pair belongs to exactly one used bucket of a chained table.
+    if (chain_type != MADS_HASH_TABLE_OPEN_ROBIN_HOOD)
+    {
+        assert_int_equal((unsigned long long int)(stats.average_chain_length * (double)stats.used_buckets + 0.5), 1000);
+    }
+
+    mads_hash_table_free(&hash_table);
+}
+
+
+static void mads_hash_table_options_test(void **state)
+{
+    mads_hash_table_t *hash_table = NULL;
+    mads_hash_table_options_t options = mads_hash_table_default_options();
+    assert_true(options.max_load_factor == MADS_HASH_TABLE_MAX_LOAD_FACTOR);
+    assert_true(options.growth_factor == MADS_HASH_TABLE_GROWTH_FACTOR);
+
+    hash_table_tuning(MADS_HASH_TABLE_CHAIN_LIST, &options);
+    hash_table_tuning(MADS_HASH_TABLE_CHAIN_TREE, &options);
+    hash_table_tuning(MADS_HASH_TABLE_OPEN_ROBIN_HOOD, &options);
+
+    // Long chains and a steep growth for chained tables, a sparse table for Robin Hood.
+    options.max_load_factor = 4.0;
+    options.growth_factor = 4.0;
+    hash_table_tuning(MADS_HASH_TABLE_CHAIN_LIST, &options);
+    hash_table_tuning(MADS_HASH_TABLE_CHAIN_TREE, &options);
+
+    hash_table = mads_hash_table_create_with_options(hash_string, MADS_HASH_TABLE_CHAIN_LIST, &options);
+    for (long long int i = 0; i < 430; i++) { mads_hash_table_insert(hash_table, create_string_integer_pair(i)); }
+    assert_int_equal(hash_table->size, 431);
+    mads_hash_table_free(&hash_table);
+
+    options.max_load_factor = 0.5;
+    options.growth_factor = 1.5;
+    hash_table_tuning(MADS_HASH_TABLE_OPEN_ROBIN_HOOD, &options);
+}
+
+
+static void hash_table_instrumentation(const int chain_type)
+{
+    mads_hash_table_t *hash_table = NULL;
+    mads_hash_table_stats_t stats;
+    unsigned long long int buckets = 0;
+    unsigned long long int pairs = 0;
+    hash_table = mads_hash_table_create(hash_string, chain_type);
+
+    for (long long int i = 0; i < 1000; i++)
+    {
+        mads_hash_table_insert(hash_table, create_string_integer_pair(i));
+    }
+
+    mads_hash_table_reset_counters(hash_table);
+    assert_int_equal(mads_hash_table_lookup(hash_table, "key-10"), 1);
+    assert_int_equal(mads_hash_table_lookup(hash_table, "key-1000"), 0);
+    assert_int_equal(mads_hash_table_lookup(hash_table, "key-999"), 1);
+
+    stats = mads_hash_table_stats(hash_table);
+
+    // The histogram covers every bucket, and its bins add up to the pairs of the table.
+    for (unsigned long long int i = 0; i < MADS_HASH_TABLE_STATS_HISTOGRAM; i++)
+    {
+        buckets += stats.histogram[i];
+        if (chain_type != MADS_HASH_TABLE_OPEN_ROBIN_HOOD) { pairs += i * stats.histogram[i]; }
+        else if (i > 0) { pairs += stats.histogram[i]; }
+    }
+
+    assert_int_equal(buckets, hash_table->size);
+    assert_int_equal(stats.histogram[0], hash_table->size - stats.used_buckets);
+    if (stats.max_chain_length < MADS_HASH_TABLE_STATS_HISTOGRAM) { assert_int_equal(pairs, 1000); }
+
+    // The operation counters are only maintained when the library is built with them.
+    if (hash_table->counters != NULL)
+    {
+        assert_int_equal(stats.counters.lookups, 3);
+        assert_int_equal(stats.counters.hits, 2);
+        assert_int_equal(stats.counters.misses, 1);
+        assert_true(stats.counters.comparisons >= 2);
+        assert_int_equal(stats.counters.rehashes, 0);
+    }
+    else
+    {
+        assert_int_equal(stats.counters.lookups, 0);
+        assert_int_equal(stats.counters.rehashes, 0);
+    }
+
+    mads_hash_table_free(&hash_table);
+}
+
+
+static void mads_hash_table_stats_test(void **state)
+{
+    hash_table_instrumentation(MADS_HASH_TABLE_CHAIN_LIST);
+    hash_table_instrumentation(MADS_HASH_TABLE_CHAIN_TREE);
+    hash_table_instrumentation(MADS_HASH_TABLE_CHAIN_HYBRID);
+    hash_table_instrumentation(MADS_HASH_TABLE_OPEN_ROBIN_HOOD);
+}
+
+
+static int string_slice_comparator(const void *s, const void *slice, const unsigned long long int length)
+{
+    const char *ss = (char *)s;
+    const int compare = strncmp(ss, (char *)slice, length);
+    if (compare != 0) { return compare; }
+    return (ss[length] != '\0' ? 1 : 0);
+}
+
+
+static void hash_table_borrowed_lookups(const int chain_type)
+{
+    mads_hash_table_t *hash_table = NULL;
+    mads_hash_table_options_t options = mads_hash_table_default_options();
+    char buffer[64];
+    options.hash_by = mads_hash_bytes;
+    options.compare_by = string_slice_comparator;
+    hash_table = mads_hash_table_create_with_options(mads_hash_string, chain_type, &options);
+
+    for (long long int i = 0; i < 500; i++)
+    {
+        mads_hash_table_insert(hash_table, create_string_integer_pair(i));
+    }
+
+    // Every key is looked up as a slice in the middle of a larger buffer, without its NUL.
+    for (long long int i = 0; i < 500; i++)
+    {
+        const int length = snprintf(buffer, sizeof(buffer), "xxkey-%lldyy", i) - 4;
+        assert_int_equal(mads_hash_table_lookup_by(hash_table, buffer + 2, length), 1);
+        assert_int_equal((long long int)mads_hash_table_get_value_by(hash_table, buffer + 2, length), i);
+        const mads_pair_t *pair = mads_hash_table_find_by(hash_table, buffer + 2, length);
+        buffer[length + 2] = '\0';
+        assert_ptr_equal(pair, mads_hash_table_find(hash_table, buffer + 2));
+    }
+
+    // Prefixes and extensions of stored keys are different keys.
+    assert_int_equal(mads_hash_table_lookup_by(hash_table, "key-123", 6), 1);
+    assert_int_equal(mads_hash_table_lookup_by(hash_table, "key-1234", 8), 0);
+    assert_int_equal(mads_hash_table_lookup_by(hash_table, "key-", 4), 0);
+    assert_int_equal(mads_hash_table_lookup_by(hash_table, "", 0), 0);
+    assert_null(mads_hash_table_get_value_by(hash_table, "key-500", 7));
+
+    mads_hash_table_remove(hash_table, "key-7");
+    assert_int_equal(mads_hash_table_lookup_by(hash_table, "key-7yy", 5), 0);
+    assert_int_equal(hash_table->n, 499);
+
+    mads_hash_table_free(&hash_table);
+}
+
+
+static void mads_hash_table_borrowed_lookup_test(void **state)
+{
+    hash_table_borrowed_lookups(MADS_HASH_TABLE_CHAIN_LIST);
+    hash_table_borrowed_lookups(MADS_HASH_TABLE_CHAIN_TREE);
+    hash_table_borrowed_lookups(MADS_HASH_TABLE_OPEN_ROBIN_HOOD);
+}
+
+
+static void hash_table_multimap_operations(const int chain_type, const unsigned long long int rehash_step)
+{
+    mads_hash_table_t *hash_table = NULL;
+    mads_hash_table_range_t range;
+    mads_pair_t *pair = NULL;
+    mads_hash_table_options_t options = mads_hash_table_default_options();
+    options.multimap = 1;
+    options.rehash_step = rehash_step;
+    hash_table = mads_hash_table_create_with_options(hash_string, chain_type, &options);
+
+    // Key i is inserted i % 5 times, interleaved with the other keys, across several resizes.
+    for (long long int round = 0; round < 5; round++)
+    {
+        for (long long int i = 0; i < 300; i++)
+        {
+            if (i % 5 > round) { mads_hash_table_insert(hash_table, create_string_integer_pair(i)); }
+        }
+    }
+
+    assert_int_equal(hash_table->n, 600);
+
+    for (long long int i = 0; i < 300; i++)
+    {
+        char key[32];
+        long long int visited = 0;
+        snprintf(key, sizeof(key), "key-%lld", i);
+        assert_int_equal(mads_hash_table_count(hash_table, key), i % 5);
+        assert_int_equal(mads_hash_table_lookup(hash_table, key), (i % 5 > 0 ? 1 : 0));
+
+        mads_hash_table_equal_range(hash_table, key, &range);
+
+        while ((pair = mads_hash_table_range_next(&range)) != NULL)
+        {
+            assert_string_equal(mads_cue_get(mads_pair_get_cue(pair)), key);
+            assert_int_equal((long long int)mads_value_get(mads_pair_get_value(pair)), i);
+            visited++;
+        }
+
+        assert_int_equal(visited, i % 5);
+    }
+
+    // A removal takes out one pair of the key at a time.
+    mads_hash_table_remove(hash_table, "key-4");
+    assert_int_equal(mads_hash_table_count(hash_table, "key-4"), 3);
+    mads_hash_table_remove(hash_table, "key-4");
+    mads_hash_table_remove(hash_table, "key-4");
+    mads_hash_table_remove(hash_table, "key-4");
+    assert_int_equal(mads_hash_table_count(hash_table, "key-4"), 0);
+    assert_int_equal(mads_hash_table_count(hash_table, "key-9"), 4);
+    assert_int_equal(hash_table->n, 596);
+
+    mads_hash_table_free(&hash_table);
+}
+
+
+static void mads_hash_table_multimap_test(void **state)
+{
+    mads_hash_table_t *hash_table = NULL;
+    mads_hash_table_range_t range;
+    hash_table_multimap_operations(MADS_HASH_TABLE_CHAIN_LIST, 0);
+    hash_table_multimap_operations(MADS_HASH_TABLE_CHAIN_LIST, 4);
+    hash_table_multimap_operations(MADS_HASH_TABLE_OPEN_ROBIN_HOOD, 0);
+
+    // Without the multimap option a key has at most one pair.
+    hash_table = mads_hash_table_create(hash_string, MADS_HASH_TABLE_CHAIN_TREE);
+    mads_pair_t *pair = create_string_integer_pair(1);
+    mads_hash_table_insert(hash_table, pair);
+    assert_int_equal(mads_hash_table_count(hash_table, "key-1"), 1);
+    assert_int_equal(mads_hash_table_count(hash_table, "key-2"), 0);
+    mads_hash_table_equal_range(hash_table, "key-1", &range);
+    assert_ptr_equal(mads_hash_table_range_next(&range), pair);
+    assert_null(mads_hash_table_range_next(&range));
+    mads_hash_table_free(&hash_table);
+}
+
+
+static void hash_table_lazy_buckets(const int chain_type)
+{
+    mads_hash_table_t *hash_table = NULL;
+    unsigned long long int allocated = 0;
+    hash_table = mads_hash_table_create_with_capacity(hash_string, chain_type, 10000, NULL);
+
+    for (unsigned long long int i = 0; i < hash_table->size; i++) { assert_null(hash_table->A[i]); }
+
+    // Lookups and removals on buckets that were never allocated find nothing.
+    assert_int_equal(mads_hash_table_lookup(hash_table, "key-1"), 0);
+    mads_hash_table_remove(hash_table, "key-1");
+    assert_int_equal(hash_table->n, 0);
+
+    // Every allocated bucket holds at least one pair, also across the resizes.
+    for (long long int i = 0; i < 20000; i++) { mads_hash_table_insert(hash_table, create_string_integer_pair(i)); }
+    for (unsigned long long int i = 0; i < hash_table->size; i++) { allocated += (hash_table->A[i] != NULL ? 1 : 0); }
+
+    assert_int_equal(allocated, mads_hash_table_stats(hash_table).used_buckets);
+    assert_int_equal(mads_hash_table_lookup(hash_table, "key-19999"), 1);
+    mads_hash_table_free(&hash_table);
+}
+
+
+static void mads_hash_table_lazy_bucket_test(void **state)
+{
+    hash_table_lazy_buckets(MADS_HASH_TABLE_CHAIN_LIST);
+    hash_table_lazy_buckets(MADS_HASH_TABLE_CHAIN_TREE);
+    hash_table_lazy_buckets(MADS_HASH_TABLE_CHAIN_HYBRID);
 }
 
 
@@ -147,7 +971,25 @@ int main(void)
     const struct CMUnitTest tests[] =
     {
         cmocka_unit_test(mads_hash_table_create_test),
-        cmocka_unit_test(mads_hash_table_free_test)
+        cmocka_unit_test(mads_hash_table_free_test),
+        cmocka_unit_test(mads_hash_table_chain_list_test),
+        cmocka_unit_test(mads_hash_table_chain_tree_test),
+        cmocka_unit_test(mads_hash_table_chain_hybrid_test),
+        cmocka_unit_test(mads_hash_table_robin_hood_test),
+        cmocka_unit_test(mads_hash_table_incremental_rehash_test),
+        cmocka_unit_test(mads_hash_table_rehash_pace_test),
+        cmocka_unit_test(mads_hash_table_pow2_sizing_test),
+        cmocka_unit_test(mads_hash_table_capacity_test),
+        cmocka_unit_test(mads_hash_table_batch_test),
+        cmocka_unit_test(mads_hash_table_iterator_test),
+        cmocka_unit_test(mads_hash_table_cached_hash_test),
+        cmocka_unit_test(mads_hash_table_clear_test),
+        cmocka_unit_test(mads_hash_table_shrink_test),
+        cmocka_unit_test(mads_hash_table_options_test),
+        cmocka_unit_test(mads_hash_table_stats_test),
+        cmocka_unit_test(mads_hash_table_borrowed_lookup_test),
+        cmocka_unit_test(mads_hash_table_multimap_test),
+        cmocka_unit_test(mads_hash_table_lazy_bucket_test)
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -0,0 +1,91 @@
+// ReSharper disable CppDFAMemoryLeak
+// ReSharper disable CppRedundantCastExpression
+// ReSharper disable CppUnusedIncludeDirective
+
+// Fixtures shared by the map tests: string keys mapped to integer values packed in the value pointer.
+// The functions are static inline, so a test that does not use one of them gets no warning for it.
+
+#ifndef MADS_TESTS_MAP_TEST_FIXTURES_H
+#define MADS_TESTS_MAP_TEST_FIXTURES_H
+
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <stdlib.h>
+
+#include <mads/data_structures/uni_hash.h>
+#include <mads/data_structures/pair.h>
+
+
+static inline int strings_comparator(const void *s, const void *l)
+{
+    const char *ss = (char *)s;
+    const char *ll = (char *)l;
+    return strcmp(ss, ll);
+}
+
+static inline void strings_printer(const void *s)
+{
+    const char *ss = (char *)s;
+    printf("%s", ss);
+}
+
+static inline void strings_destructor(void *s)
+{
+    char *ss = (char *)s;
+    free(ss);
+}
+
+static inline int integers_comparator(const void *i, const void *j)
+{
+    const long long int *ii = (long long int *)&i;
+    const long long int *jj = (long long int *)&j;
+
+    if (*ii > *jj) { return 1; }
+    if (*ii < *jj) { return -1; }
+    return 0;
+}
+
+static inline void integers_printer(const void *x)
+{
+    const long long int *xx = (long long int *)&x;
+    printf("%lld", *xx);
+}
+
+static inline unsigned long long int hash_string(const mads_uni_hash_t *uni_hash, const void *data)
+{
+    unsigned long long int max_k;
+    unsigned long long int tab_size;
+    unsigned long long int k = 0;
+    unsigned long long int hval = 0;
+    const char *string_key = (char *)data;
+
+    tab_size = mads_uni_hash_get_table_size(uni_hash);
+    max_k = mads_uni_hash_get_k(uni_hash);
+
+    for (unsigned long long int i = 0; string_key[i] != '\0'; i++)
+    {
+        hval += string_key[i] * uni_hash->values[k];
+        k++;
+        if (k == max_k) { k = 0; }
+    }
+
+    return hval % tab_size;
+}
+
+static inline mads_pair_t *create_string_integer_pair(const long long int number)
+{
+    char *key = NULL;
+    mads_cue_t *cue = NULL;
+    mads_value_t *value = NULL;
+
+    key = (char *)malloc(sizeof(char) * 32);
+    assert(key != NULL);
+    snprintf(key, 32, "key-%lld", number);
+
+    cue = mads_cue_create(key, strings_comparator, strings_printer, strings_destructor);
+    value = mads_value_create((void *)number, integers_comparator, integers_printer, NULL);
+    return mads_pair_create(cue, value);
+}
+
+#endif //MADS_TESTS_MAP_TEST_FIXTURES_H
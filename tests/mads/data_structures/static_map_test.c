@@ -0,0 +1,126 @@
+// ReSharper disable CppDFAMemoryLeak
+// ReSharper disable CppDFANullDereference
+// ReSharper disable CppRedundantCastExpression
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ReSharper disable CppDeclaratorNeverUsed
+// ReSharper disable CppUnusedIncludeDirective
+
+// ReSharper disable CppParameterNeverUsed
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <cmocka.h>
+#include <string.h>
+#include <assert.h>
+#include <stdlib.h>
+
+#include <mads/algorithms/hash.h>
+#include <mads/data_structures/static_map.h>
+
+#include "map_test_fixtures.h"
+
+
+static void static_map_operations(const int chain_type, const long long int elements)
+{
+    char key[32];
+    mads_hash_table_t *hash_table = mads_hash_table_create(mads_hash_string, chain_type);
+
+    for (long long int i = 0; i < elements; i++)
+    {
+        mads_hash_table_insert(hash_table, create_string_integer_pair(i));
+    }
+
+    mads_static_map_t *static_map = mads_static_map_build(hash_table);
+    assert_non_null(static_map);
+    assert_int_equal(static_map->n, elements);
+
+    // The hash is minimal: every slot holds a pair.
+    for (long long int i = 0; i < elements; i++)
+    {
+        assert_non_null(static_map->slots[i]);
+    }
+
+    for (long long int i = 0; i < elements; i++)
+    {
+        snprintf(key, sizeof(key), "key-%lld", i);
+        assert_int_equal(mads_static_map_lookup(static_map, key), 1);
+        assert_int_equal((long long int)mads_static_map_get_value(static_map, key), i);
+        assert_ptr_equal(mads_static_map_find(static_map, key), mads_hash_table_find(hash_table, key));
+    }
+
+    for (long long int i = elements; i < elements + 100; i++)
+    {
+        snprintf(key, sizeof(key), "key-%lld", i);
+        assert_int_equal(mads_static_map_lookup(static_map, key), 0);
+        assert_null(mads_static_map_get_value(static_map, key));
+    }
+
+    // The pairs are borrowed, so the table frees them after the map is gone.
+    mads_static_map_free(&static_map);
+    assert_null(static_map);
+    mads_hash_table_free(&hash_table);
+}
+
+
+static void mads_static_map_build_test(void **state)
+{
+    static_map_operations(MADS_HASH_TABLE_CHAIN_LIST, 10000);
+    static_map_operations(MADS_HASH_TABLE_CHAIN_TREE, 1000);
+    static_map_operations(MADS_HASH_TABLE_OPEN_ROBIN_HOOD, 1000);
+}
+
+
+static void mads_static_map_small_test(void **state)
+{
+    static_map_operations(MADS_HASH_TABLE_CHAIN_LIST, 0);
+    static_map_operations(MADS_HASH_TABLE_CHAIN_LIST, 1);
+    static_map_operations(MADS_HASH_TABLE_CHAIN_LIST, 2);
+    static_map_operations(MADS_HASH_TABLE_CHAIN_LIST, 7);
+}
+
+
+static void mads_static_map_multimap_test(void **state)
+{
+    mads_hash_table_options_t options = mads_hash_table_default_options();
+    options.multimap = 1;
+
+    const int chain_types[] = { MADS_HASH_TABLE_CHAIN_LIST, MADS_HASH_TABLE_OPEN_ROBIN_HOOD };
+
+    for (int c = 0; c < 2; c++)
+    {
+        char key[32];
+        mads_hash_table_t *hash_table = mads_hash_table_create_with_options(mads_hash_string, chain_types[c], &options);
+
+        // Every key is inserted three times, as three distinct pairs.
+        for (long long int copy = 0; copy < 3; copy++)
+        {
+            for (long long int i = 0; i < 500; i++) { mads_hash_table_insert(hash_table, create_string_integer_pair(i)); }
+        }
+
+        assert_int_equal(hash_table->n, 1500);
+        mads_static_map_t *static_map = mads_static_map_build(hash_table);
+        assert_int_equal(static_map->n, 500);
+
+        for (long long int i = 0; i < 500; i++)
+        {
+            snprintf(key, sizeof(key), "key-%lld", i);
+            assert_ptr_equal(mads_static_map_find(static_map, key), mads_hash_table_find(hash_table, key));
+        }
+
+        mads_static_map_free(&static_map);
+        mads_hash_table_free(&hash_table);
+    }
+}
+
+
+int main(void)
+{
+    const struct CMUnitTest tests[] =
+    {
+        cmocka_unit_test(mads_static_map_build_test),
+        cmocka_unit_test(mads_static_map_small_test),
+        cmocka_unit_test(mads_static_map_multimap_test)
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,90 @@
+// ReSharper disable CppDFAMemoryLeak
+// ReSharper disable CppDFANullDereference
+// ReSharper disable CppRedundantCastExpression
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ReSharper disable CppDeclaratorNeverUsed
+// ReSharper disable CppUnusedIncludeDirective
+
+// ReSharper disable CppParameterNeverUsed
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <cmocka.h>
+#include <string.h>
+#include <assert.h>
+#include <stdlib.h>
+
+#include <mads/data_structures/typed_array.h>
+
+
+typedef struct
+{
+    double x;
+    double y;
+} point_t;
+
+MADS_DEFINE_ARRAY(integer_array, long long int)
+MADS_DEFINE_ARRAY(point_array, point_t)
+
+
+static void mads_typed_array_test(void **state)
+{
+    integer_array_t *array = integer_array_create();
+    assert_int_equal(integer_array_is_empty(array), 1);
+
+    for (long long int i = 0; i < 1000; i++) { integer_array_append(array, i); }
+
+    integer_array_prepend(array, -1);
+    integer_array_insert_at(array, 500, -500);
+    integer_array_insert_at(array, integer_array_size(array), 1000);
+    assert_int_equal(integer_array_size(array), 1003);
+    assert_int_equal(integer_array_get_at(array, 0), -1);
+    assert_int_equal(integer_array_get_at(array, 499), 498);
+    assert_int_equal(integer_array_get_at(array, 500), -500);
+    assert_int_equal(integer_array_get_at(array, 501), 499);
+    assert_int_equal(integer_array_get_at(array, 1002), 1000);
+
+    integer_array_remove_at(array, 500);
+    integer_array_remove_at(array, 0);
+    integer_array_remove_at(array, integer_array_size(array) - 1);
+    assert_int_equal(integer_array_size(array), 1000);
+
+    // The elements are stored contiguously, by value.
+    const long long int *data = integer_array_data(array);
+    for (long long int i = 0; i < 1000; i++) { assert_int_equal(data[i], i); }
+
+    *integer_array_at(array, 7) += 100;
+    integer_array_set_at(array, 8, -8);
+    assert_int_equal(integer_array_get_at(array, 7), 107);
+    assert_int_equal(integer_array_get_at(array, 8), -8);
+
+    integer_array_clear(array);
+    assert_int_equal(integer_array_is_empty(array), 1);
+    integer_array_free(&array);
+    assert_null(array);
+
+    point_array_t *points = point_array_create();
+    point_array_reserve(points, 100);
+    assert_true(points->memsize >= 100);
+
+    for (int i = 0; i < 100; i++)
+    {
+        const point_t point = { (double)i, (double)-i };
+        point_array_append(points, point);
+    }
+
+    assert_true(point_array_get_at(points, 42).x == 42.0);
+    assert_true(point_array_at(points, 42)->y == -42.0);
+    point_array_free(&points);
+}
+
+
+int main(void)
+{
+    const struct CMUnitTest tests[] =
+    {
+        cmocka_unit_test(mads_typed_array_test)
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,144 @@
+// ReSharper disable CppDFAMemoryLeak
+// ReSharper disable CppDFANullDereference
+// ReSharper disable CppRedundantCastExpression
+// ReSharper disable CppJoinDeclarationAndAssignment
+// ReSharper disable CppDeclaratorNeverUsed
+// ReSharper disable CppUnusedIncludeDirective
+
+// ReSharper disable CppParameterNeverUsed
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <cmocka.h>
+#include <string.h>
+#include <assert.h>
+#include <stdlib.h>
+
+#include <mads/data_structures/typed_hash_map.h>
+
+
+typedef struct
+{
+    double x;
+    double y;
+} point_t;
+
+static unsigned long long int hash_integer(const long long int key)
+{
+    return (unsigned long long int)key;
+}
+
+static int integers_equal(const long long int a, const long long int b)
+{
+    return a == b;
+}
+
+static unsigned long long int hash_string(const char *key)
+{
+    unsigned long long int hval = 14695981039346656037ULL;
+
+    for (unsigned long long int i = 0; key[i] != '\0'; i++)
+    {
+        hval = (hval ^ (unsigned char)key[i]) * 1099511628211ULL;
+    }
+
+    return hval;
+}
+
+static int strings_equal(const char *a, const char *b)
+{
+    return strcmp(a, b) == 0;
+}
+
+MADS_DEFINE_HASH_MAP(integer_map, long long int, long long int, hash_integer, integers_equal)
+MADS_DEFINE_HASH_MAP(string_map, const char *, point_t, hash_string, strings_equal)
+
+
+static void mads_typed_hash_map_test(void **state)
+{
+    long long int value = 0;
+    int inserted = 0;
+    integer_map_t *map = integer_map_create();
+
+    // Sequential keys with the identity hash still spread over the slots.
+    for (long long int i = 0; i < 100000; i++)
+    {
+        assert_int_equal(integer_map_insert(map, i, i * 2), 1);
+    }
+
+    assert_int_equal(integer_map_insert(map, 7, 0), 0);
+    assert_int_equal(integer_map_size(map), 100000);
+    assert_true(map->n * 100 <= map->capacity * MADS_TYPED_HASH_MAP_MAX_LOAD_PERCENT);
+
+    for (long long int i = 0; i < 100000; i++)
+    {
+        assert_int_equal(integer_map_get(map, i, &value), 1);
+        assert_int_equal(value, i * 2);
+    }
+
+    assert_int_equal(integer_map_lookup(map, 100000), 0);
+    assert_null(integer_map_find(map, -1));
+
+    // Aggregation through the returned value pointer.
+    for (long long int i = 0; i < 1000; i++)
+    {
+        *integer_map_find_or_insert(map, i % 10 + 1000000, 0, &inserted) += 1;
+        assert_int_equal(inserted, (i < 10 ? 1 : 0));
+    }
+
+    for (long long int i = 0; i < 10; i++) { assert_int_equal(*integer_map_find(map, i + 1000000), 100); }
+
+    for (long long int i = 0; i < 100000; i += 2)
+    {
+        assert_int_equal(integer_map_remove(map, i), 1);
+        assert_int_equal(integer_map_remove(map, i), 0);
+    }
+
+    assert_int_equal(integer_map_size(map), 50010);
+
+    for (long long int i = 0; i < 100000; i++)
+    {
+        assert_int_equal(integer_map_lookup(map, i), (int)(i % 2));
+    }
+
+    unsigned long long int position = 0;
+    unsigned long long int visited = 0;
+    const integer_map_slot_t *slot = NULL;
+
+    while ((slot = integer_map_next(map, &position)) != NULL)
+    {
+        assert_int_equal(slot->value, (slot->key >= 1000000 ? 100 : slot->key * 2));
+        visited++;
+    }
+
+    assert_int_equal(visited, 50010);
+
+    integer_map_clear(map);
+    assert_int_equal(integer_map_size(map), 0);
+    assert_int_equal(integer_map_lookup(map, 1), 0);
+    integer_map_free(&map);
+    assert_null(map);
+
+    string_map_t *strings = string_map_create();
+    const point_t origin = { 0.0, 0.0 };
+    const point_t unit = { 1.0, 1.0 };
+    string_map_reserve(strings, 1000);
+    const unsigned long long int capacity = strings->capacity;
+    assert_int_equal(string_map_insert(strings, "origin", origin), 1);
+    assert_int_equal(string_map_insert(strings, "unit", unit), 1);
+    assert_int_equal(strings->capacity, capacity);
+    assert_true(string_map_find(strings, "unit")->x == 1.0);
+    assert_null(string_map_find(strings, "none"));
+    string_map_free(&strings);
+}
+
+
+int main(void)
+{
+    const struct CMUnitTest tests[] =
+    {
+        cmocka_unit_test(mads_typed_hash_map_test)
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}